@@ -296,6 +296,80 @@ verify() {
 int breakOnID = -1;
 int breakOnRemoveID = -1;
 
+
+//
+// AST node allocation
+//
+// The compiler creates and deletes millions of small AST nodes, and
+// deletes most of the dead ones together in cleanAst().  Rather than
+// going to malloc for each one, nodes are carved out of larger chunks,
+// with a separate chunk for each size (rounded up to astNodeAlign), so
+// nodes of the same kind end up next to each other.  A deleted node is
+// put on the free list for its size and reused by the next node of that
+// size.  The chunks are never returned to malloc.
+//
+// Nodes larger than astNodeMaxSize, of which there are few, use the
+// global operator new and delete.
+//
+
+struct AstFreeNode {
+  AstFreeNode* next;
+};
+
+static const size_t astNodeAlign         = 16;
+static const size_t astNodeMaxSize       = 1024;
+static const size_t astNodesPerChunk     = 1024;
+static const size_t astNumSizeClasses    = astNodeMaxSize / astNodeAlign + 1;
+
+static AstFreeNode* astFreeLists[astNumSizeClasses];
+static char*        astChunkNext[astNumSizeClasses];
+static size_t       astChunkLeft[astNumSizeClasses];
+
+void* BaseAST::operator new(size_t size) {
+  if (size > astNodeMaxSize) {
+    return ::operator new(size);
+  }
+
+  size_t sizeClass = (size + astNodeAlign - 1) / astNodeAlign;
+  void*  retval    = NULL;
+
+  if (AstFreeNode* node = astFreeLists[sizeClass]) {
+    astFreeLists[sizeClass] = node->next;
+    retval                  = node;
+
+  } else {
+    if (astChunkLeft[sizeClass] == 0) {
+      size_t nodeSize = sizeClass * astNodeAlign;
+
+      astChunkNext[sizeClass] = (char*) ::operator new(nodeSize *
+                                                       astNodesPerChunk);
+      astChunkLeft[sizeClass] = astNodesPerChunk;
+    }
+
+    retval                   = astChunkNext[sizeClass];
+    astChunkNext[sizeClass] += sizeClass * astNodeAlign;
+    astChunkLeft[sizeClass] -= 1;
+  }
+
+  return retval;
+}
+
+void BaseAST::operator delete(void* ptr, size_t size) {
+  if (ptr == NULL) {
+    // nothing to do
+
+  } else if (size > astNodeMaxSize) {
+    ::operator delete(ptr);
+
+  } else {
+    size_t       sizeClass = (size + astNodeAlign - 1) / astNodeAlign;
+    AstFreeNode* node      = (AstFreeNode*) ptr;
+
+    node->next              = astFreeLists[sizeClass];
+    astFreeLists[sizeClass] = node;
+  }
+}
+
 int lastNodeIDUsed() {
   return uid - 1;
 }
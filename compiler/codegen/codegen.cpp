@@ -1348,7 +1348,7 @@ static void codegen_defn(std::set<const char*> & cnames, std::vector<TypeSymbol*
   genComment("Virtual Method Table");
   genVirtualMethodTable(types, false);
 
-  if(fIncrementalCompilation) {
+  if(fIncrementalCompilation || fCPartitions > 1) {
     genComment("Global Variables");
     forv_Vec(VarSymbol, varSymbol, globals) {
       varSymbol->codegenGlobalDef(false);
@@ -2252,6 +2252,10 @@ void codegen(void) {
   fileinfo defnfile = { NULL, NULL, NULL };
   fileinfo strconfig = { NULL, NULL, NULL };
 
+  // --c-partitions files, and their FILE*s for ModuleSymbol
+  std::vector<fileinfo> partfiles;
+  std::vector<FILE*>    partitions;
+
   GenInfo* info     = gGenInfo;
 
   INT_ASSERT(info);
@@ -2280,6 +2284,9 @@ void codegen(void) {
     if(fIncrementalCompilation)
       USR_FATAL("Incremental compilation is not yet supported with LLVM");
 
+    if(fCPartitions > 1)
+      USR_FATAL("--c-partitions is not supported with LLVM");
+
     if(printCppLineno || debugCCode)
     {
       debug_info = new debug_data(*info->module);
@@ -2331,7 +2338,22 @@ void codegen(void) {
       }
     }
 
-    codegen_makefile(&mainfile, NULL, false, userFileName);
+    std::vector<const char*> partFileName;
+    if(fCPartitions > 1) {
+      for (int i = 1; i <= fCPartitions; i++) {
+        fileinfo partfile;
+        openCFile(&partfile, astr("chpl__part", istr(i)), "c");
+        fprintf(partfile.fptr, "#include \"chpl__header.h\"\n");
+        partfiles.push_back(partfile);
+        partitions.push_back(partfile.fptr);
+
+        // The Makefile wants the name without its .c
+        std::string path(partfile.pathname);
+        partFileName.push_back(astr(path.substr(0, path.size()-2).c_str()));
+      }
+    }
+
+    codegen_makefile(&mainfile, NULL, false, userFileName, partFileName);
     if (fLibraryCompile && fLibraryMakefile) {
       codegen_library_makefile();
     }
@@ -2386,6 +2408,14 @@ void codegen(void) {
       const char* filename = NULL;
       filename = generateFileName(fileNameHashMap, filename,currentModule->name);
 
+      // With --c-partitions, functions go to the partition files instead
+      // of per-module files (except user modules with --incremental).
+      if(partitions.size() > 0 &&
+         !(fIncrementalCompilation && (currentModule->modTag == MOD_USER))) {
+        currentModule->codegenDefPartitioned(partitions);
+        continue;
+      }
+
       fileinfo modulefile;
       openCFile(&modulefile, filename, "c");
       info->cfile = modulefile.fptr;
@@ -2412,6 +2442,8 @@ void codegen(void) {
     closeCFile(&mainfile);
     closeCFile(&defnfile);
     closeCFile(&strconfig);
+    for (size_t i = 0; i < partfiles.size(); i++)
+      closeCFile(&partfiles[i]);
   }
 
   if (fPrintEmittedCodeSize)
@@ -2430,6 +2462,9 @@ void makeBinary(void) {
 #endif
   } else {
     const char* makeflags = printSystemCommands ? "-f " : "-s -f ";
+    // let make compile the --c-partitions files in parallel
+    if (fCPartitions > 1)
+      makeflags = astr("-j", istr(fCPartitions), " ", makeflags);
     const char* command = astr(astr(CHPL_MAKE, " "),
                                makeflags,
                                getIntermediateDirName(), "/Makefile");
@@ -578,7 +578,7 @@ void VarSymbol::codegenDefC(bool global, bool isHeader) {
   //
   std::string str;
 
-  if(fIncrementalCompilation) {
+  if(fIncrementalCompilation || fCPartitions > 1) {
     bool addExtern =  global && isHeader;
     str = (addExtern ? "extern " : "") + typestr + " " + cname;
   } else {
@@ -1431,7 +1431,8 @@ void FnSymbol::codegenHeaderC(void) {
   if (fGenIDS)
     fprintf(outfile, "%s", idCommentTemp(this));
 
-  if (!fIncrementalCompilation && !hasFlag(FLAG_EXPORT) && !hasFlag(FLAG_EXTERN)) {
+  if (!fIncrementalCompilation && fCPartitions <= 1 &&
+      !hasFlag(FLAG_EXPORT) && !hasFlag(FLAG_EXTERN)) {
     fprintf(outfile, "static ");
   }
   fprintf(outfile, "%s", codegenFunctionType(true).c.c_str());
@@ -1909,6 +1910,34 @@ static int compareLineno(void* v1, void* v2) {
 }
 
 void ModuleSymbol::codegenDef() {
+  std::vector<FILE*> noPartitions;
+
+  codegenDefPartitioned(noPartitions);
+}
+
+// Returns the partition with the least code written to it so far.
+static FILE* smallestPartition(std::vector<FILE*>& partitions) {
+  FILE* ret     = partitions[0];
+  long  retSize = ftell(ret);
+
+  for (size_t i = 1; i < partitions.size(); i++) {
+    long size = ftell(partitions[i]);
+
+    if (size < retSize) {
+      ret     = partitions[i];
+      retSize = size;
+    }
+  }
+
+  return ret;
+}
+
+//
+// Generate the module's functions.  For --c-partitions, each function
+// goes to whichever partition file is smallest at the time, so that
+// the files the back-end compiles in parallel are of similar size.
+//
+void ModuleSymbol::codegenDefPartitioned(std::vector<FILE*>& partitions) {
   GenInfo* info = gGenInfo;
 
   info->filename = fname();
@@ -1940,6 +1969,9 @@ void ModuleSymbol::codegenDef() {
 #endif
 
   for_vector(FnSymbol, fn, fns) {
+    if (partitions.size() > 0)
+      info->cfile = smallestPartition(partitions);
+
     fn->codegenDef();
   }
 
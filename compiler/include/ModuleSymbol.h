@@ -64,6 +64,7 @@ public:
   // Interface to Symbol
   virtual void            replaceChild(BaseAST* oldAst, BaseAST* newAst);
   virtual void            codegenDef();
+  void                    codegenDefPartitioned(std::vector<FILE*>& partitions);
 
   // New interface
   std::vector<AggregateType*> getTopLevelClasses();
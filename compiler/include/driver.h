@@ -221,6 +221,10 @@ extern bool fMinimalModules;
 // Set to true if we want to enable incremental compilation.
 extern bool fIncrementalCompilation;
 
+// If greater than 1, the number of C files to spread generated
+// functions across, so that the back-end can compile them in parallel.
+extern int fCPartitions;
+
 // Set to true if we want to use the experimental
 // Interactive Programming Environment (IPE) mode.
 extern bool fUseIPE;
@@ -125,6 +125,10 @@ bool canDispatch(Type*     actualType,
                  bool*     paramNarrows= NULL,
                  bool      paramCoerce = false);
 
+// canDispatch() results are cached while resolve() runs.  Call this
+// after changing an existing type's dispatch parents or promotion type.
+void clearCanDispatchCache();
+
 
 void parseExplainFlag(char* flag, int* line, ModuleSymbol** module);
 
@@ -164,6 +164,7 @@ bool fNoRemoveEmptyRecords = true;
 bool fRemoveUnreachableBlocks = true;
 bool fMinimalModules = false;
 bool fIncrementalCompilation = false;
+int  fCPartitions = 0;
 bool fUseIPE         = false;
 
 int optimize_on_clause_limit = 20;
@@ -886,6 +887,7 @@ static ArgumentDescription arg_desc[] = {
  {"savec", ' ', "<directory>", "Save generated C code in directory", "P", saveCDir, "CHPL_SAVEC_DIR", verifySaveCDir},
 
  {"", ' ', NULL, "C Code Compilation Options", NULL, NULL, NULL, NULL},
+ {"c-partitions", ' ', "<n>", "Split generated C code into <n> files compiled in parallel", "I", &fCPartitions, "CHPL_C_PARTITIONS", NULL},
  {"ccflags", ' ', "<flags>", "Back-end C compiler flags (can be specified multiple times)", "S", NULL, "CHPL_CC_FLAGS", setCCFlags},
  {"debug", 'g', NULL, "[Don't] Support debugging of generated C code", "N", &debugCCode, "CHPL_DEBUG", setChapelDebug},
  {"dynamic", ' ', NULL, "Generate a dynamically linked binary", "F", &fLinkStyle, NULL, setDynamicLink},
@@ -925,6 +927,7 @@ static ArgumentDescription arg_desc[] = {
 
  {"", ' ', NULL, "Compiler Configuration Options", NULL, NULL, NULL, NULL},
  {"home", ' ', "<path>", "Path to Chapel's home directory", "S", NULL, "_CHPL_HOME", setHome},
+ {"chplenv-cache", ' ', "<directory>", "Cache Chapel configuration settings in directory", "P", chplenvCacheDir, "CHPL_ENV_CACHE_DIR", NULL},
  {"atomics", ' ', "<atomics-impl>", "Specify atomics implementation", "S", NULL, "_CHPL_ATOMICS", setEnv},
  {"network-atomics", ' ', "<network>", "Specify network atomics implementation", "S", NULL, "_CHPL_NETWORK_ATOMICS", setEnv},
  {"aux-filesys", ' ', "<aio-system>", "Specify auxiliary I/O system", "S", NULL, "_CHPL_AUX_FILESYS", setEnv},
@@ -1317,6 +1320,15 @@ static void checkIncrementalAndOptimized() {
               " using -O optimizations directly.");
 }
 
+static void checkCPartitionsAndOptimized() {
+  std::size_t optimizationsEnabled = ccflags.find("-O");
+  if(fCPartitions > 1 && ( optimizeCCode ||
+      optimizationsEnabled!=std::string::npos ))
+    USR_WARN("Compiling with --c-partitions along with optimizations enabled"
+              " may lead to a slower execution time, since functions in"
+              " different partitions cannot be inlined into each other.");
+}
+
 static void postprocess_args() {
   // Processes that depend on results of passed arguments or values of CHPL_vars
 
@@ -1337,6 +1349,8 @@ static void postprocess_args() {
   checkTargetArch();
 
   checkIncrementalAndOptimized();
+
+  checkCPartitionsAndOptimized();
 }
 
 int main(int argc, char* argv[]) {
@@ -65,6 +65,7 @@
 
 #include "../ifa/prim_data.h"
 
+#include <algorithm>
 #include <cmath>
 #include <inttypes.h>
 #include <map>
@@ -1178,6 +1179,168 @@ bool doCanDispatch(Type*     actualType,
   return retval;
 }
 
+/************************************* | **************************************
+*                                                                             *
+* A cache of canDispatch() results, in use while resolve() runs.              *
+*                                                                             *
+* doCanDispatch() only looks at the actual symbol if it is a param, and only  *
+* looks at fn to see whether it is NULL, '=', or a build-tuple that allows    *
+* refs.  So other calls can be keyed on the two types, that kind of fn, and   *
+* paramCoerce.  New types are fine, but an existing type that gains a         *
+* dispatch parent or a promotion type can change earlier answers, so the      *
+* places that do that clear the cache.                                        *
+*                                                                             *
+************************************** | *************************************/
+
+class DispatchCacheEntry {
+public:
+  Type*    actualType;       // NULL if the slot is empty
+  Type*    formalType;
+  unsigned kind;
+  bool     retval;
+  bool     promotes;
+  bool     paramNarrows;
+};
+
+static const unsigned DISPATCH_CACHE_NONE = ~0U;
+
+static bool                            dispatchCacheOn     = false;
+static std::vector<DispatchCacheEntry> dispatchCache;
+static size_t                          dispatchCacheUsed   = 0;
+
+static unsigned long                   dispatchCacheCalls  = 0;
+static unsigned long                   dispatchCacheHits   = 0;
+static unsigned long                   dispatchCacheClears = 0;
+
+static unsigned dispatchCacheKind(Type*     actualType,
+                                  Symbol*   actualSym,
+                                  FnSymbol* fn,
+                                  bool      paramCoerce) {
+  unsigned retval = (paramCoerce == true) ? 1 : 0;
+
+  if (dispatchCacheOn == false || actualType == NULL)
+    return DISPATCH_CACHE_NONE;
+
+  if (actualSym != NULL && actualSym->isImmediate() == true)
+    return DISPATCH_CACHE_NONE;
+
+  if (fn != NULL) {
+    retval |= 2;
+
+    if (fn->name == astrSequals)
+      retval |= 4;
+
+    if (fn->hasFlag(FLAG_BUILD_TUPLE) == true &&
+        fn->hasFlag(FLAG_ALLOW_REF)   == true)
+      retval |= 8;
+  }
+
+  return retval;
+}
+
+static DispatchCacheEntry* dispatchCacheFind(Type*    actualType,
+                                             Type*    formalType,
+                                             unsigned kind) {
+  uint64_t key  = ((uint64_t) (uintptr_t) actualType * 31 +
+                   (uint64_t) (uintptr_t) formalType) * 31 + kind;
+  size_t   mask = dispatchCache.size() - 1;
+
+  for (size_t i = (size_t) ((key * UINT64_C(0x9E3779B97F4A7C15)) >> 32) & mask;
+       ;
+       i = (i + 1) & mask) {
+    DispatchCacheEntry* entry = &dispatchCache[i];
+
+    if (entry->actualType == NULL ||
+        (entry->actualType == actualType &&
+         entry->formalType == formalType &&
+         entry->kind       == kind)) {
+      return entry;
+    }
+  }
+}
+
+static void dispatchCacheAdd(Type*    actualType,
+                             Type*    formalType,
+                             unsigned kind,
+                             bool     retval,
+                             bool     promotes,
+                             bool     paramNarrows) {
+  DispatchCacheEntry* entry = NULL;
+
+  // Keep the table at most half full
+  if (2 * (dispatchCacheUsed + 1) > dispatchCache.size()) {
+    std::vector<DispatchCacheEntry> old;
+
+    old.swap(dispatchCache);
+    dispatchCache.resize(2 * old.size());
+
+    for (size_t i = 0; i < old.size(); i++) {
+      if (old[i].actualType != NULL) {
+        *dispatchCacheFind(old[i].actualType,
+                           old[i].formalType,
+                           old[i].kind) = old[i];
+      }
+    }
+  }
+
+  entry = dispatchCacheFind(actualType, formalType, kind);
+
+  if (entry->actualType == NULL)
+    dispatchCacheUsed++;
+
+  entry->actualType   = actualType;
+  entry->formalType   = formalType;
+  entry->kind         = kind;
+  entry->retval       = retval;
+  entry->promotes     = promotes;
+  entry->paramNarrows = paramNarrows;
+}
+
+static void startCanDispatchCache() {
+  DispatchCacheEntry empty = { NULL, NULL, 0, false, false, false };
+
+  dispatchCache.assign(4096, empty);
+  dispatchCacheUsed = 0;
+  dispatchCacheOn   = true;
+}
+
+void clearCanDispatchCache() {
+  DispatchCacheEntry empty = { NULL, NULL, 0, false, false, false };
+
+  if (dispatchCacheUsed > 0) {
+    std::fill(dispatchCache.begin(), dispatchCache.end(), empty);
+    dispatchCacheUsed = 0;
+    dispatchCacheClears++;
+  }
+}
+
+static void stopCanDispatchCache() {
+  if (printPasses == true || printPassesFile != NULL) {
+    char   text[128];
+    double rate = 0.0;
+
+    if (dispatchCacheCalls > 0)
+      rate = 100.0 * dispatchCacheHits / dispatchCacheCalls;
+
+    snprintf(text, sizeof(text),
+             "%32s : %lu calls, %.1f%% hits, %lu clears\n",
+             "canDispatch cache",
+             dispatchCacheCalls,
+             rate,
+             dispatchCacheClears);
+
+    if (printPasses == true)
+      fputs(text, stderr);
+
+    if (printPassesFile != NULL)
+      fputs(text, printPassesFile);
+  }
+
+  std::vector<DispatchCacheEntry>().swap(dispatchCache);
+  dispatchCacheUsed = 0;
+  dispatchCacheOn   = false;
+}
+
 bool canDispatch(Type*     actualType,
                  Symbol*   actualSym,
                  Type*     formalType,
@@ -1185,15 +1348,54 @@ bool canDispatch(Type*     actualType,
                  bool*     promotes,
                  bool*     paramNarrows,
                  bool      paramCoerce) {
-  bool tmpPromotes     = false;
-  bool tmpParamNarrows = false;
-  bool retval          = doCanDispatch(actualType,
-                                       actualSym,
-                                       formalType,
-                                       fn,
-                                       &tmpPromotes,
-                                       &tmpParamNarrows,
-                                       paramCoerce);
+  bool     tmpPromotes     = false;
+  bool     tmpParamNarrows = false;
+  bool     retval          = false;
+  unsigned kind            = dispatchCacheKind(actualType,
+                                               actualSym,
+                                               fn,
+                                               paramCoerce);
+
+  if (kind != DISPATCH_CACHE_NONE) {
+    DispatchCacheEntry* entry = dispatchCacheFind(actualType,
+                                                  formalType,
+                                                  kind);
+
+    dispatchCacheCalls++;
+
+    if (entry->actualType != NULL) {
+      dispatchCacheHits++;
+
+      retval          = entry->retval;
+      tmpPromotes     = entry->promotes;
+      tmpParamNarrows = entry->paramNarrows;
+
+    } else {
+      retval = doCanDispatch(actualType,
+                             actualSym,
+                             formalType,
+                             fn,
+                             &tmpPromotes,
+                             &tmpParamNarrows,
+                             paramCoerce);
+
+      dispatchCacheAdd(actualType,
+                       formalType,
+                       kind,
+                       retval,
+                       tmpPromotes,
+                       tmpParamNarrows);
+    }
+
+  } else {
+    retval = doCanDispatch(actualType,
+                           actualSym,
+                           formalType,
+                           fn,
+                           &tmpPromotes,
+                           &tmpParamNarrows,
+                           paramCoerce);
+  }
 
   if (promotes     != NULL) {
     *promotes = tmpPromotes;
@@ -1983,6 +2185,8 @@ void resolvePromotionType(AggregateType* at) {
     INT_ASSERT(promoFn->retTag == RET_TYPE);
 
     at->scalarPromotionType = promoFn->retType;
+
+    clearCanDispatchCache();
   }
 }
 
@@ -7454,6 +7658,8 @@ void resolve() {
 
   parseExplainFlag(fExplainCall, &explainCallLine, &explainCallModule);
 
+  startCanDispatchCache();
+
   computeStandardModuleSet(); // Lydia NOTE 09/12/16: is not linked to our
   // treatment on functions included by default, leading to bugs with qualified
   // access to symbols included in this way.
@@ -7549,6 +7755,8 @@ void resolve() {
   freeCache(genericsCache);
   freeCache(promotionsCache);
 
+  stopCanDispatchCache();
+
   visibleFunctionsClear();
 
   std::map<int, SymbolMap*>::iterator it;
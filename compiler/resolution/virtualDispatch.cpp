@@ -462,6 +462,8 @@ static void overrideIterator(FnSymbol* pfn, FnSymbol* cfn) {
     atPfnRetType->dispatchChildren.add_exclusive(atCfnRetType);
     atCfnRetType->dispatchParents.add_exclusive(atPfnRetType);
 
+    clearCanDispatchCache();
+
     INT_ASSERT(cic->symbol->hasFlag(FLAG_ITERATOR_CLASS) == true);
     INT_ASSERT(atCthisType->dispatchParents.n              == 1);
 
@@ -31,6 +31,7 @@
 
 #include <map>
 #include <set>
+#include <vector>
 
 
 /*
@@ -48,19 +49,70 @@
    symbols available to all modules (i.e. what is in ChapelStandard)
    is considered to be in a single block. This optimization
    provides a significant performance improvement for compiling 'hello'.
+
+   When the walk from a block only passes through plain 'use's, the
+   blocks it visits don't depend on the name being looked up.  That
+   list of blocks is computed once per block (VisibleFunctionClosure)
+   and the functions found for each name are memoized on it.  A memo
+   is recomputed only when a function with its name is added to one of
+   the blocks in the closure.
  */
 
+class VisibleFunctionClosure;
+
 class VisibleFunctionBlock {
 public:
                                         VisibleFunctionBlock();
 
   Map<const char*, Vec<FnSymbol*>*>     visibleFunctions;
+
+  // The blocks visible from this block, if it has been computed
+  VisibleFunctionClosure*               closure;
+};
+
+class VisibleFunctionMemo {
+public:
+  // The functions found, before checking isVisible() for the call
+  Vec<FnSymbol*>                        fns;
+
+  // How much of the name's addedFunctionBlocks list was accounted for
+  int                                   nAdded;
+};
+
+//
+// The blocks searched for calls in a block, in the order that
+// getVisibleFunctions() visits them.  The walk also depends on the
+// instantiation points of the functions it passes through, which can
+// change after resolving calls in them, so those are checked before
+// the closure is used.
+//
+class VisibleFunctionClosure {
+public:
+                                        VisibleFunctionClosure();
+                                       ~VisibleFunctionClosure();
+
+  // Set if the walk reached a 'use' with an only, except or rename list,
+  // or a private module.  The blocks visited then depend on the name or
+  // on the call, so calls in this block do the walk every time.
+  bool                                  filtered;
+
+  std::vector<BlockStmt*>               blocks;
+  std::set<BlockStmt*>                  blockSet;
+
+  std::vector<FnSymbol*>                inFns;
+  std::vector<BlockStmt*>               inFnInstantiationPoints;
+
+  Map<const char*, VisibleFunctionMemo*> memos;
 };
 
 static Map<BlockStmt*, VisibleFunctionBlock*> visibleFunctionMap;
 
 static int                                    nVisibleFunctions       = 0;
 
+// For each function name, the blocks that functions with that name
+// were added to, in order
+static Map<const char*, Vec<BlockStmt*>*>     addedFunctionBlocks;
+
 
 
 /************************************* | **************************************
@@ -150,6 +202,13 @@ static void buildVisibleFunctionMap() {
         vfb->visibleFunctions.put(fn->name, fns);
       }
       fns->add(fn);
+
+      Vec<BlockStmt*>* added = addedFunctionBlocks.get(fn->name);
+      if (!added) {
+        added = new Vec<BlockStmt*>();
+        addedFunctionBlocks.put(fn->name, added);
+      }
+      added->add(block);
     }
   }
   nVisibleFunctions = gFnSymbols.n;
@@ -169,13 +228,208 @@ static void getVisibleFunctions(const char*           name,
                                 std::set<BlockStmt*>& visited,
                                 Vec<FnSymbol*>&       visibleFns);
 
+static VisibleFunctionClosure* getClosure(BlockStmt* block);
+
+static VisibleFunctionMemo* getMemo(VisibleFunctionClosure* closure,
+                                    const char*             name);
+
 void getVisibleFunctions(const char*      name,
                          CallExpr*        call,
                          Vec<FnSymbol*>&  visibleFns) {
-  BlockStmt*           block    = getVisibilityScope(call);
-  std::set<BlockStmt*> visited;
+  BlockStmt*              block   = getVisibilityScope(call);
+  VisibleFunctionClosure* closure = NULL;
+
+  // don't hide the walk that --break-on-resolve-id prints
+  if (call->id != breakOnResolveID) {
+    closure = getClosure(block);
+  }
+
+  if (closure != NULL && closure->filtered == false) {
+    VisibleFunctionMemo* memo = getMemo(closure, name);
+
+    forv_Vec(FnSymbol, fn, memo->fns) {
+      if (fn->isVisible(call) == true) {
+        visibleFns.add(fn);
+      }
+    }
+
+  } else {
+    std::set<BlockStmt*> visited;
 
-  getVisibleFunctions(name, call, block, visited, visibleFns);
+    getVisibleFunctions(name, call, block, visited, visibleFns);
+  }
+}
+
+//
+// A block that defines no functions, uses no modules, and is not a module
+// or instantiated function body adds nothing to the walk.  Calls in it
+// can share the closure of the enclosing block.
+//
+static BlockStmt* getClosureBlock(BlockStmt* block) {
+  while (block != rootModule->block &&
+         block->useList == NULL &&
+         standardModuleSet.set_in(block) == NULL) {
+    VisibleFunctionBlock* vfb = visibleFunctionMap.get(block);
+
+    if (vfb != NULL && vfb->visibleFunctions.n != 0)
+      break;
+
+    if (block->parentExpr == NULL) {
+      ModuleSymbol* inMod = block->getModule();
+      FnSymbol*     inFn  = block->getFunction();
+
+      if (inMod != NULL && block == inMod->block)
+        break;
+
+      if (inFn != NULL && inFn->instantiationPoint() != NULL)
+        break;
+    }
+
+    block = getVisibilityScope(block);
+  }
+
+  return block;
+}
+
+static bool isClosureCurrent(VisibleFunctionClosure* closure) {
+  for (size_t i = 0; i < closure->inFns.size(); i++) {
+    BlockStmt* instantiationPt = closure->inFns[i]->instantiationPoint();
+
+    if (instantiationPt != closure->inFnInstantiationPoints[i] ||
+        (instantiationPt != NULL && instantiationPt->parentSymbol == NULL))
+      return false;
+  }
+
+  return true;
+}
+
+static void buildClosure(VisibleFunctionClosure* closure, BlockStmt* block);
+
+static VisibleFunctionClosure* getClosure(BlockStmt* block) {
+  BlockStmt*            closureBlock = getClosureBlock(block);
+  VisibleFunctionBlock* vfb          = visibleFunctionMap.get(closureBlock);
+
+  if (vfb == NULL) {
+    vfb = new VisibleFunctionBlock();
+    visibleFunctionMap.put(closureBlock, vfb);
+  }
+
+  if (vfb->closure != NULL && isClosureCurrent(vfb->closure) == false) {
+    delete vfb->closure;
+    vfb->closure = NULL;
+  }
+
+  if (vfb->closure == NULL) {
+    vfb->closure = new VisibleFunctionClosure();
+    buildClosure(vfb->closure, closureBlock);
+  }
+
+  return vfb->closure;
+}
+
+//
+// Record the blocks visited by getVisibleFunctions(), below, in the same
+// order.  This stops early if the closure turns out to be filtered.
+//
+static void buildClosure(VisibleFunctionClosure* closure, BlockStmt* block) {
+  if (standardModuleSet.set_in(block)) {
+    block = theProgram->block;
+  }
+
+  if (closure->blockSet.insert(block).second == false) {
+    return;
+  }
+
+  closure->blocks.push_back(block);
+
+  ModuleSymbol* inMod           = block->getModule();
+  FnSymbol*     inFn            = block->getFunction();
+  BlockStmt*    instantiationPt = NULL;
+
+  if (block->parentExpr == NULL &&
+      (inMod == NULL || block != inMod->block) &&
+      inFn != NULL) {
+    BlockStmt* inFnInstantiationPoint = inFn->instantiationPoint();
+
+    if (inFnInstantiationPoint && !inFnInstantiationPoint->parentSymbol) {
+      INT_FATAL(inFn, "instantiation point not in tree\n"
+                      "try --break-on-remove-id %i and consider making\n"
+                      "that block scopeless",
+                      inFnInstantiationPoint->id);
+    }
+
+    instantiationPt = inFnInstantiationPoint;
+
+    closure->inFns.push_back(inFn);
+    closure->inFnInstantiationPoints.push_back(inFnInstantiationPoint);
+  }
+
+  if (block->useList != NULL) {
+    for_actuals(expr, block->useList) {
+      UseStmt* use = toUseStmt(expr);
+      SymExpr* se  = toSymExpr(use->src);
+
+      INT_ASSERT(use && se);
+
+      if (ModuleSymbol* mod = toModuleSymbol(se->symbol())) {
+        if (use->isPlainUse() == false || mod->hasFlag(FLAG_PRIVATE)) {
+          closure->filtered = true;
+          return;
+        }
+
+        buildClosure(closure, mod->block);
+
+        if (closure->filtered == true) {
+          return;
+        }
+      }
+    }
+  }
+
+  if (block != rootModule->block) {
+    buildClosure(closure, getVisibilityScope(block));
+
+    if (instantiationPt != NULL && closure->filtered == false) {
+      buildClosure(closure, instantiationPt);
+    }
+  }
+}
+
+static VisibleFunctionMemo* getMemo(VisibleFunctionClosure* closure,
+                                    const char*             name) {
+  Vec<BlockStmt*>*     added  = addedFunctionBlocks.get(name);
+  int                  nAdded = (added != NULL) ? added->n : 0;
+  VisibleFunctionMemo* memo   = closure->memos.get(name);
+  bool                 stale  = false;
+
+  if (memo == NULL) {
+    memo = new VisibleFunctionMemo();
+    closure->memos.put(name, memo);
+    stale = true;
+
+  } else {
+    for (int i = memo->nAdded; i < nAdded && stale == false; i++) {
+      stale = closure->blockSet.count(added->v[i]) != 0;
+    }
+  }
+
+  if (stale == true) {
+    memo->fns.clear();
+
+    for (size_t i = 0; i < closure->blocks.size(); i++) {
+      BlockStmt* block = closure->blocks[i];
+
+      if (VisibleFunctionBlock* vfb = visibleFunctionMap.get(block)) {
+        if (Vec<FnSymbol*>* fns = vfb->visibleFunctions.get(name)) {
+          memo->fns.append(*fns);
+        }
+      }
+    }
+  }
+
+  memo->nAdded = nAdded;
+
+  return memo;
 }
 
 static void getVisibleFunctions(const char*           name,
@@ -459,10 +713,21 @@ void visibleFunctionsClear() {
       delete vfn;
     }
 
+    delete vfb->closure;
     delete vfb;
   }
 
   visibleFunctionMap.clear();
+
+  Vec<Vec<BlockStmt*>*> addeds;
+
+  addedFunctionBlocks.get_values(addeds);
+
+  forv_Vec(Vec<BlockStmt*>, added, addeds) {
+    delete added;
+  }
+
+  addedFunctionBlocks.clear();
 }
 
 /************************************* | **************************************
@@ -472,5 +737,19 @@ void visibleFunctionsClear() {
 ************************************** | *************************************/
 
 VisibleFunctionBlock::VisibleFunctionBlock() {
+  closure = NULL;
+}
+
+VisibleFunctionClosure::VisibleFunctionClosure() {
+  filtered = false;
+}
 
+VisibleFunctionClosure::~VisibleFunctionClosure() {
+  Vec<VisibleFunctionMemo*> vmemos;
+
+  memos.get_values(vmemos);
+
+  forv_Vec(VisibleFunctionMemo, memo, vmemos) {
+    delete memo;
+  }
 }
@@ -38,17 +38,22 @@
 #include "stlUtil.h"
 #include "stringutil.h"
 #include "tmpdirname.h"
+#include "version.h"
 
 #ifdef HAVE_LLVM
 #include "llvm/Support/FileSystem.h"
 #endif
 
+#include <dirent.h>
 #include <pwd.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cstring>
 #include <cstdlib>
 #include <cerrno>
+#include <fstream>
+#include <sstream>
 #include <string>
 #include <map>
 
@@ -59,6 +64,7 @@ char               executableFilename[FILENAME_MAX + 1] = "";
 char               libmodeHeadername[FILENAME_MAX + 1]  = "";
 char               pythonModulename[FILENAME_MAX + 1]   = "";
 char               saveCDir[FILENAME_MAX + 1]           = "";
+char               chplenvCacheDir[FILENAME_MAX + 1]    = "";
 
 std::string ccflags;
 std::string ldflags;
@@ -506,6 +512,158 @@ const char* createDebuggerFile(const char* debugger, int argc, char* argv[]) {
   return dbgfilename;
 }
 
+//
+// printchplenv takes a noticeable part of the time to compile a small
+// program, and its output rarely changes.  With --chplenv-cache, it is
+// saved in the given directory, in a file named by a hash of everything
+// that could change it: the command, the environment variables it reads,
+// the compiler version, and the timestamps of the chplenv scripts, the
+// chplconfig files and the third-party packages.
+//
+
+static void hashBytes(uint64_t& hash, const char* s, size_t len) {
+  // FNV-1a
+  for (size_t i = 0; i < len; i++) {
+    hash ^= (unsigned char) s[i];
+    hash *= 0x100000001b3ULL;
+  }
+  // separate this from whatever is hashed next
+  hash ^= 0xff;
+  hash *= 0x100000001b3ULL;
+}
+
+static void hashString(uint64_t& hash, const std::string& s) {
+  hashBytes(hash, s.c_str(), s.length());
+}
+
+static void hashFileStamp(uint64_t& hash, const std::string& path) {
+  struct stat st;
+  std::ostringstream stamp;
+
+  stamp << path;
+  if (stat(path.c_str(), &st) == 0) {
+    stamp << " " << (long long) st.st_mtime << " " << (long long) st.st_size;
+  }
+  hashString(hash, stamp.str());
+}
+
+static void hashDirStamps(uint64_t& hash, const std::string& dir,
+                          const char* subdir) {
+  std::vector<std::string> names;
+
+  if (DIR* d = opendir(dir.c_str())) {
+    while (struct dirent* ent = readdir(d)) {
+      if (ent->d_name[0] != '.') {
+        names.push_back(ent->d_name);
+      }
+    }
+    closedir(d);
+  }
+  std::sort(names.begin(), names.end());
+
+  hashFileStamp(hash, dir);
+  for (size_t i = 0; i < names.size(); i++) {
+    hashFileStamp(hash, dir + "/" + names[i]);
+    if (subdir != NULL) {
+      hashFileStamp(hash, dir + "/" + names[i] + "/" + subdir);
+    }
+  }
+}
+
+// Environment variables that printchplenv consults, directly or by
+// looking for compilers.  Others, such as CI job IDs, would only defeat
+// the cache.  The cache directory itself doesn't affect the output, and
+// leaving it out lets the flag and CHPL_ENV_CACHE_DIR share entries.
+static bool isChplEnvInput(const char* var) {
+  static const char* prefixes[] = { "CHPL_", "CRAY", "PE_", "PATH=", "HOME=",
+                                    "HADOOP_INSTALL=", "JAVA_INSTALL=",
+                                    NULL };
+
+  if (strncmp(var, "CHPL_ENV_CACHE_DIR=", 19) == 0) {
+    return false;
+  }
+
+  for (int i = 0; prefixes[i] != NULL; i++) {
+    if (strncmp(var, prefixes[i], strlen(prefixes[i])) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static std::string chplenvCacheFile(const std::string& command) {
+  extern char** environ;
+  std::vector<std::string> env;
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  char version[128];
+  char name[64];
+
+  hashString(hash, command);
+
+  for (char** e = environ; *e != NULL; e++) {
+    if (isChplEnvInput(*e)) {
+      env.push_back(*e);
+    }
+  }
+  std::sort(env.begin(), env.end());
+  for (size_t i = 0; i < env.size(); i++) {
+    hashString(hash, env[i]);
+  }
+
+  get_version(version);
+  hashString(hash, version);
+
+  std::string home = CHPL_HOME;
+  hashFileStamp(hash, home + "/util/printchplenv");
+  hashDirStamps(hash, home + "/util/chplenv", NULL);
+  hashDirStamps(hash, home + "/third-party", "install");
+  hashFileStamp(hash, home + "/chplconfig");
+  if (const char* config = getenv("CHPL_CONFIG")) {
+    hashFileStamp(hash, std::string(config) + "/chplconfig");
+  }
+  if (const char* userHome = getenv("HOME")) {
+    hashFileStamp(hash, std::string(userHome) + "/.chplconfig");
+  }
+
+  snprintf(name, sizeof(name), "/chplenv-%016llx", (unsigned long long) hash);
+
+  return std::string(chplenvCacheDir) + name;
+}
+
+static bool readChplEnvCache(const std::string& path, std::string& output) {
+  std::ifstream in(path.c_str());
+
+  if (!in) {
+    return false;
+  }
+
+  std::stringstream contents;
+  contents << in.rdbuf();
+  output = contents.str();
+
+  // Ignore anything that doesn't look like printchplenv output
+  return output.find("CHPL_HOME=") != std::string::npos;
+}
+
+static void writeChplEnvCache(const std::string& path,
+                              const std::string& output) {
+  // Failing to write the cache isn't an error; we'll just run printchplenv
+  // again next time.  Write to a temporary file and rename it, so that
+  // concurrent compiles never read a partial file.
+  std::ostringstream tmp;
+  tmp << path << ".tmp." << (long) getpid();
+
+  mkdir(chplenvCacheDir, 0755);
+
+  std::ofstream out(tmp.str().c_str());
+  out << output;
+  out.close();
+
+  if (!out || rename(tmp.str().c_str(), path.c_str()) != 0) {
+    unlink(tmp.str().c_str());
+  }
+}
+
 std::string runPrintChplEnv(std::map<std::string, const char*> varMap) {
   // Run printchplenv script, passing currently known CHPL_vars as well
   std::string command = "";
@@ -519,7 +677,19 @@ std::string runPrintChplEnv(std::map<std::string, const char*> varMap) {
   // Toss stderr away until printchplenv supports a '--suppresswarnings' flag
   command += std::string(CHPL_HOME) + "/util/printchplenv --all --internal --no-tidy --simple 2> /dev/null";
 
-  return runCommand(command);
+  if (chplenvCacheDir[0] == '\0') {
+    return runCommand(command);
+  }
+
+  std::string cacheFile = chplenvCacheFile(command);
+  std::string output;
+
+  if (!readChplEnvCache(cacheFile, output)) {
+    output = runCommand(command);
+    writeChplEnvCache(cacheFile, output);
+  }
+
+  return output;
 }
 
 std::string getVenvDir() {
@@ -603,6 +773,23 @@ static void genCFileBuildRules(FILE* makefile) {
 }
 
 
+//
+// The --c-partitions files have their own rules (rather than being
+// compiled in the Makefile.exe recipe like CHPLUSEROBJ) so that
+// 'make -j' can compile them in parallel.
+//
+static void genPartitionBuildRules(FILE* makefile,
+                                   const std::vector<const char*>& files) {
+  for (size_t i = 0; i < files.size(); i++) {
+    fprintf(makefile, "%s.o: %s.c FORCE\n", files[i], files[i]);
+    fprintf(makefile,
+            "\t$(CC) $(CHPL_MAKE_BASE_CFLAGS) $(GEN_CFLAGS) "
+            "$(COMP_GEN_CFLAGS) -c -o $@ $(CHPL_RT_INC_DIR) $<\n");
+    fprintf(makefile, "\n");
+  }
+}
+
+
 static void genObjFiles(FILE* makefile) {
   int filenum = 0;
   int first = 1;
@@ -638,7 +825,7 @@ void genIncludeCommandLineHeaders(FILE* outfile) {
 }
 
 
-void codegen_makefile(fileinfo* mainfile, const char** tmpbinname, bool skip_compile_link, const std::vector<const char*>& splitFiles) {
+void codegen_makefile(fileinfo* mainfile, const char** tmpbinname, bool skip_compile_link, const std::vector<const char*>& splitFiles, const std::vector<const char*>& partitionFiles) {
   fileinfo makefile;
   openCFile(&makefile, "Makefile");
   const char* tmpDirName = intDirName;
@@ -761,6 +948,10 @@ void codegen_makefile(fileinfo* mainfile, const char** tmpbinname, bool skip_com
   for(int i=0; i<(int)splitFiles.size(); i++)
     fprintf(makefile.fptr, "\t%s \\\n", splitFiles[i]);
   fprintf(makefile.fptr, "\n");
+  fprintf(makefile.fptr, "CHPL_PARTITION_OBJS = \\\n");
+  for(int i=0; i<(int)partitionFiles.size(); i++)
+    fprintf(makefile.fptr, "\t%s.o \\\n", partitionFiles[i]);
+  fprintf(makefile.fptr, "\n");
   genCFiles(makefile.fptr);
   genObjFiles(makefile.fptr);
   fprintf(makefile.fptr, "\nLIBS =");
@@ -788,6 +979,7 @@ void codegen_makefile(fileinfo* mainfile, const char** tmpbinname, bool skip_com
   }
   fprintf(makefile.fptr, "\n");
   genCFileBuildRules(makefile.fptr);
+  genPartitionBuildRules(makefile.fptr, partitionFiles);
   closeCFile(&makefile, false);
 }
 
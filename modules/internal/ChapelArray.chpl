@@ -167,10 +167,6 @@ module ChapelArray {
   use ArrayViewRankChange;
   use ArrayViewReindex;
 
-  // Explicitly use a processor atomic, as most calls to this function are
-  // likely be on locale 0
-  pragma "no doc"
-  var numPrivateObjects: chpl__processorAtomicType(int);
   pragma "no doc"
   param nullPid = -1;
 
@@ -221,12 +217,15 @@ module ChapelArray {
   // without communication.
   proc _newPrivatizedClass(value) : int {
 
-    const n = numPrivateObjects.fetchAdd(1);
-
     const hereID = here.id;
     const privatizeData = value.dsiGetPrivatizeData();
-    on Locales[0] do
+    var n: int;
+    on Locales[0] {
+      // Pids are handed out (and recycled) by the runtime on Locale 0
+      extern proc chpl_newPrivatizedPid(): int;
+      n = chpl_newPrivatizedPid();
       _newPrivatizedClassHelp(value, value, n, hereID, privatizeData);
+    }
 
     proc _newPrivatizedClassHelp(parentValue, originalValue, n, hereID, privatizeData) {
       var newValue = originalValue;
@@ -262,14 +261,9 @@ module ChapelArray {
       _freePrivatizedClassHelp(pid, original);
     }
 
+    // Free the subtree's copies before this locale's, so that Locale 0,
+    // the root, clears the pid last and can safely recycle it.
     proc _freePrivatizedClassHelp(pid, original) {
-      var prv = chpl_getPrivatizedCopy(object, pid);
-      if prv != original then
-        delete _to_unmanaged(prv);
-
-      extern proc chpl_clearPrivatizedClass(pid:int);
-      chpl_clearPrivatizedClass(pid);
-
       cobegin {
         if chpl_localeTree.left then
           on chpl_localeTree.left do
@@ -278,6 +272,13 @@ module ChapelArray {
           on chpl_localeTree.right do
             _freePrivatizedClassHelp(pid, original);
       }
+
+      var prv = chpl_getPrivatizedCopy(object, pid);
+      if prv != original then
+        delete _to_unmanaged(prv);
+
+      extern proc chpl_clearPrivatizedClass(pid:int);
+      chpl_clearPrivatizedClass(pid);
     }
   }
 
@@ -455,6 +455,10 @@ module Buffers {
         qbuffer_release(ret._buf_internal);
       }
 
+      // Start over with an empty buffer, since we just released the old one.
+      var err = qbuffer_create(ret._buf_internal);
+      if err then try ioerror(err, "in buffer assignment");
+
       var start_offset:int(64);
       var end_offset:int(64);
 
@@ -137,6 +137,40 @@
   was executed on locale 0, and a remote get and a remote put were
   executed on locale 1.
 
+  **Remote Data Cache Counts**
+
+  Programs compiled with ``--cache-remote`` can also retrieve counts of
+  what the remote data cache did while communication was being
+  counted, to see how effective it was for a given program::
+
+    startCommDiagnostics();
+    // ...
+    stopCommDiagnostics();
+    writeln(getCacheDiagnostics());
+
+  These are kept separately from the communication counts, and have
+  their own reset calls (:proc:`resetCacheDiagnostics` and
+  :proc:`resetCacheDiagnosticsHere`).  Without the remote data cache
+  all of them are zero.
+
+  **Counting by Source Location**
+
+  To find out which lines of a program are responsible for its
+  communication, without changing the program, set the environment
+  variable ``CHPL_RT_COMM_DIAGS_BY_SITE`` to true when running it.
+  Each locale then counts every comm operation it initiates, by the
+  file and line that caused it, for the whole run.  At exit each
+  locale prints a table of the sites that did the most communication,
+  with the number of GETs, PUTs and remote executions and the bytes
+  moved by the GETs and PUTs.  Sites are ordered by total operation
+  count, and only the first 20 are printed.  A different number can be
+  given in ``CHPL_RT_COMM_DIAGS_BY_SITE_TOP``; a negative value prints
+  them all.  Remote executions don't carry source locations yet, so
+  they are all reported against a single ``<unknown>`` site.
+
+  Each pthread counts into its own table, so this is cheap enough to
+  leave on for production-sized runs, unlike on-the-fly reporting.
+
   **Studying Communication During Module Initialization**
 
   It is hard for a programmer to determine exactly what happens during
@@ -238,6 +272,76 @@ module CommDiagnostics
    */
   type commDiagnostics = chpl_commDiagnostics;
 
+  /* Aggregated remote data cache event counts.  As with
+     :record:`chpl_commDiagnostics`, this duplicates the runtime's
+     definition.  GETs are counted once for each cache page they touch.
+   */
+  extern record chpl_cacheDiagnostics {
+    /*
+      GETs satisfied entirely from the cache
+     */
+    var get_hits: uint(64);
+    /*
+      GETs for which the page was cached but some of the requested
+      lines were not, requiring a remote GET
+     */
+    var get_partial_hits: uint(64);
+    /*
+      GETs for which the page was not cached at all
+     */
+    var get_misses: uint(64);
+    /*
+      pages read ahead by sequential readahead, stride prefetching, or
+      explicit prefetches
+     */
+    var readahead_issued: uint(64);
+    /*
+      pages read ahead that were later used by a GET
+     */
+    var readahead_used: uint(64);
+    /*
+      PUTs started to write back dirty data
+     */
+    var dirty_flushes: uint(64);
+    /*
+      pages evicted from the cache's first-access (Ain) queue
+     */
+    var ain_evictions: uint(64);
+    /*
+      page records dropped from the cache's history (Aout) queue
+     */
+    var aout_evictions: uint(64);
+    /*
+      pages evicted from the cache's frequently-used (Am) queue
+     */
+    var am_evictions: uint(64);
+    /*
+      cached pages discarded because of an acquire fence
+     */
+    var acquire_invalidations: uint(64);
+
+    proc writeThis(c) {
+      use Reflection;
+
+      var first = true;
+      c <~> "(";
+      for param i in 1..numFields(chpl_cacheDiagnostics) {
+        const val = getField(this, i);
+        if val != 0 {
+          if first then first = false; else c <~> ", ";
+          c <~> getFieldName(chpl_cacheDiagnostics, i) <~> " = " <~> val;
+        }
+      }
+      if first then c <~> "<no cache activity>";
+      c <~> ")";
+    }
+  };
+
+  /*
+    The Chapel record type inherits the runtime definition of it.
+   */
+  type cacheDiagnostics = chpl_cacheDiagnostics;
+
   private extern proc chpl_startVerboseComm();
 
   private extern proc chpl_stopVerboseComm();
@@ -258,6 +362,10 @@ module CommDiagnostics
 
   private extern proc chpl_getCommDiagnosticsHere(out cd: commDiagnostics);
 
+  private extern proc chpl_resetCacheDiagnosticsHere();
+
+  private extern proc chpl_getCacheDiagnosticsHere(out cd: cacheDiagnostics);
+
   /*
     Start on-the-fly reporting of communication initiated on any locale.
    */
@@ -347,6 +455,47 @@ module CommDiagnostics
     return cd;
   }
 
+  /*
+    Reset remote data cache counts across the whole program.
+   */
+  proc resetCacheDiagnostics() {
+    for loc in Locales do on loc do
+      resetCacheDiagnosticsHere();
+  }
+
+  /*
+    Reset remote data cache counts on the calling locale.
+   */
+  inline proc resetCacheDiagnosticsHere() {
+    chpl_resetCacheDiagnosticsHere();
+  }
+
+  /*
+    Retrieve remote data cache counts for the whole program.
+
+    :returns: array of counts of cache events on each locale
+    :rtype: `[LocaleSpace] cacheDiagnostics`
+   */
+  proc getCacheDiagnostics() {
+    var D: [LocaleSpace] cacheDiagnostics;
+    for loc in Locales do on loc {
+      D(loc.id) = getCacheDiagnosticsHere();
+    }
+    return D;
+  }
+
+  /*
+    Retrieve remote data cache counts for this locale.
+
+    :returns: counts of cache events on this locale
+    :rtype: `cacheDiagnostics`
+   */
+  proc getCacheDiagnosticsHere() {
+    var cd: cacheDiagnostics;
+    chpl_getCacheDiagnosticsHere(cd);
+    return cd;
+  }
+
 
   /*
     If this is set, on-the-fly reporting of communication operations
@@ -204,6 +204,13 @@ channel.unlock(). Note that in the future, we may move to alternative ways of
 calling these functions that guarantee that they are not called on a channel
 without the appropriate locking.
 
+Since most channels are only ever used by the task that created them, on
+Linux a channel's lock is biased toward the first task that takes it, which
+makes locking nearly free for that task.  The first time another task takes
+the lock, the bias is revoked and the lock behaves normally from then on.
+Setting the environment variable ``CHPL_RT_QIO_BIASED_LOCKS`` to false at
+execution time disables this.
+
 Besides data races that can occur if locking is not used in channels when it
 should be, it is also possible for there to be data races on file data that is
 buffered simultaneously in multiple channels.  The main way to avoid such data
@@ -419,7 +426,9 @@ module IO {
       -- seems that we'd want some way to cache that...).
     - Create leader/follower iterators for ItemReader/ItemWriter so that these
       are as efficient as possible when working with fixed-size data types
-      (ie, they can open up channels that are not shared).
+      (ie, they can open up channels that are not shared).  ItemReaders
+      created by file.lines() already support standalone parallel
+      iteration via file.records().
 */
 
 use SysBasic;
@@ -657,6 +666,8 @@ extern const QIO_METHOD_FREADFWRITE:c_int;
 pragma "no doc"
 extern const QIO_METHOD_MMAP:c_int;
 pragma "no doc"
+extern const QIO_METHOD_URING:c_int;
+pragma "no doc"
 extern const QIO_METHODMASK:c_int;
 pragma "no doc"
 extern const QIO_HINT_RANDOM:c_int;
@@ -885,6 +896,7 @@ private extern proc qio_file_unlock(f:qio_file_ptr_t);
 private extern proc qio_file_sync(f:qio_file_ptr_t):syserr;
 
 private extern proc qio_channel_end_offset_unlocked(ch:qio_channel_ptr_t):int(64);
+private extern proc qio_channel_get_file(ch:qio_channel_ptr_t):qio_file_ptr_t;
 private extern proc qio_file_get_style(f:qio_file_ptr_t, ref style:iostyle);
 private extern proc qio_file_length(f:qio_file_ptr_t, ref len:int(64)):syserr;
 
@@ -1108,6 +1120,11 @@ private extern const QIO_CONV_SET_DONE:c_int;
 
 private extern proc qio_conv_parse(const fmt:c_string, start:size_t, ref end:uint(64), scanning:c_int, ref spec:qio_conv_t, ref style:iostyle):syserr;
 
+pragma "no doc"
+extern type qio_conv_plan_ptr_t;
+private extern proc qio_conv_plan_get(const fmt:c_string, len:size_t, scanning:c_int):qio_conv_plan_ptr_t;
+private extern proc qio_conv_plan_parse(plan:qio_conv_plan_ptr_t, const fmt:c_string, start:size_t, ref end:uint(64), scanning:c_int, ref spec:qio_conv_t, ref style:iostyle):syserr;
+
 private extern proc qio_format_error_too_many_args():syserr;
 private extern proc qio_format_error_too_few_args():syserr;
 private extern proc qio_format_error_arg_mismatch(arg:int):syserr;
@@ -1508,7 +1525,9 @@ proc file.length():int(64) throws {
   var err:syserr = ENOERR;
   var len:int(64) = 0;
   on this.home {
-    err = qio_file_length(this._file_internal, len);
+    var local_len:int(64);
+    err = qio_file_length(this._file_internal, local_len);
+    len = local_len;
   }
   if err then try ioerror(err, "in file.length()");
   return len;
@@ -2671,7 +2690,8 @@ proc file.reader(out error:syserr, param kind=iokind.dynamic, param locking=true
   return new channel(writing=false, kind=kind, locking=locking);
 }
 
-/* Iterate over all of the lines in a file.
+/* Iterate over all of the lines in a file.  Within a ``forall`` loop,
+   the lines are read in parallel as described for :proc:`file.records`.
 
    Throws a SystemError if an ItemReader could not be returned.
 
@@ -2714,6 +2734,148 @@ proc file.lines(out error:syserr, param locking:bool = true, start:int(64) = 0,
   return ret;
 }
 
+/* Iterate over the records in a file that are terminated by the byte
+   ``sep``.  Each yielded string includes its separator, except possibly
+   for the last record in the region.  With the default ``sep``, this
+   yields the same strings as :proc:`file.lines`.
+
+   Within a ``forall`` loop, this iterator splits the region
+   ``[start, end)`` into byte ranges and reads them in parallel, each
+   with its own channel.  A record belongs to the range holding its first
+   byte, so each range skips past the first separator at or before its
+   start and then reads records until one starts past its end.  Records
+   are not yielded in file order.
+
+   The ranges are spread over ``targetLocales`` and then over the
+   ``dataParTasksPerLocale`` tasks of each locale.  A locale other than
+   the file's home opens the file by path, so this should only be used
+   with more than one locale when the file is on a shared filesystem.
+   When the path is not available, such locales read the file remotely.
+   ``targetLocales`` is ignored by serial iteration.
+
+   The separator must be an ASCII byte, below ``0x80``.  Records are read
+   as strings, so a larger byte could be matched in the middle of a
+   multibyte character when splitting the region but not when reading it.
+
+   Halts if ``sep`` is not an ASCII byte, or if the file is invalid or
+   cannot be read.
+
+   :arg sep: the ASCII byte terminating each record
+   :arg start: the byte offset at which to begin reading
+   :arg end: the byte offset at which to stop reading
+   :arg hints: hints for the channels reading the file
+   :arg local_style: the style to use for the channels reading the file
+   :arg targetLocales: the locales that read the file in parallel
+ */
+iter file.records(sep:uint(8) = 0x0a, start:int(64) = 0,
+                  end:int(64) = max(int(64)), hints:iohints = IOHINT_NONE,
+                  in local_style:iostyle = this._style,
+                  targetLocales:[] locale = [this.home]) : string {
+  _checkRecordsSep(sep);
+
+  for rec in this._recordsInRange(sep, start, start, max(int(64)), end,
+                                  hints, local_style) do
+    yield rec;
+}
+
+pragma "no doc"
+iter file.records(param tag:iterKind, sep:uint(8) = 0x0a, start:int(64) = 0,
+                  end:int(64) = max(int(64)), hints:iohints = IOHINT_NONE,
+                  in local_style:iostyle = this._style,
+                  targetLocales:[] locale = [this.home]) : string
+    where tag == iterKind.standalone {
+  // Ranges shorter than this aren't worth a task and a channel of their own.
+  param minRangeBytes = 64 * 1024;
+
+  _checkRecordsSep(sep);
+
+  var stop:int(64);
+  try! {
+    stop = min(end, this.length());
+  }
+  if stop <= start then return;
+
+  const path = this.tryGetPath();
+  const numLocs = targetLocales.size;
+  const numBytes = stop - start;
+
+  coforall (loc, locIdx) in zip(targetLocales, 0..) do on loc {
+    const locLo = start + numBytes * locIdx / numLocs,
+          locHi = start + numBytes * (locIdx + 1) / numLocs;
+
+    var f = this;
+    if f.home != here && path != "unknown" {
+      try {
+        f = open(path, iomode.r);
+      } catch {
+        // Keep reading the file from its home locale.
+      }
+    }
+
+    const maxTasks = if dataParTasksPerLocale == 0 then here.maxTaskPar
+                     else dataParTasksPerLocale;
+    const numTasks = max(1, min(maxTasks, (locHi - locLo) / minRangeBytes));
+
+    coforall tid in 0..#numTasks {
+      const lo = locLo + (locHi - locLo) * tid / numTasks,
+            hi = locLo + (locHi - locLo) * (tid + 1) / numTasks;
+      if lo < hi {
+        for rec in f._recordsInRange(sep, start, lo, hi, stop,
+                                     hints, local_style) do
+          yield rec;
+      }
+    }
+  }
+}
+
+pragma "no doc"
+proc _checkRecordsSep(sep:uint(8)) {
+  if sep >= 0x80 then
+    halt("file.records() separator must be an ASCII byte, not ", sep);
+}
+
+//
+// Yield the records of the region [regionStart, stop) that begin in
+// [lo, hi).  A record that begins before lo belongs to an earlier
+// range, so unless lo is the start of the region, skip past the first
+// separator at or after lo-1.
+//
+pragma "no doc"
+iter file._recordsInRange(sep:uint(8), regionStart:int(64), lo:int(64),
+                          hi:int(64), stop:int(64), hints:iohints,
+                          in local_style:iostyle) : string {
+  try! this.check();
+
+  local_style.string_format = QIO_STRING_FORMAT_TOEND;
+  local_style.string_end = sep;
+
+  const skip = lo > regionStart;
+  var r = try! this.reader(iokind.dynamic, locking=false,
+                           start=if skip then lo - 1 else lo, end=stop,
+                           hints=hints, style=local_style);
+  var more = true;
+  if skip {
+    try {
+      r.advancePastByte(sep);
+    } catch e: EOFError {
+      // No record begins in this range.
+      more = false;
+    } catch e {
+      halt(e.message());
+    }
+  }
+
+  while more && r.offset() < hi {
+    var rec:string;
+    try! {
+      more = r.read(rec);
+    }
+    if more then yield rec;
+  }
+
+  try! r.close();
+}
+
 /*
    Create a :record:`channel` that supports writing to a file. See
    :ref:`about-io-overview`.
@@ -4427,6 +4589,43 @@ record ItemReader {
       yield x;
     }
   }
+
+  /* iterate through the lines read from a channel created by
+     :proc:`file.lines` in parallel, using :proc:`file.records`.
+     This reads the rest of the channel's region directly from its
+     file, so the channel itself is left where it was.  Other
+     ItemReaders iterate serially.
+   */
+  iter these(param tag:iterKind) where tag == iterKind.standalone {
+    var f:file;
+    var start, end:int(64);
+    var style:iostyle;
+    var byLines = false;
+    if ItemType == string {
+      on ch.home {
+        try! ch.lock();
+        style = ch._style();
+        byLines = style.binary == 0 &&
+                  style.string_format == QIO_STRING_FORMAT_TOEND &&
+                  style.string_end >= 0 && style.string_end < 0x80;
+        if byLines {
+          f.home = here;
+          f._file_internal = qio_channel_get_file(ch._channel_internal);
+          qio_file_retain(f._file_internal);
+          start = qio_channel_offset_unlocked(ch._channel_internal);
+          end = qio_channel_end_offset_unlocked(ch._channel_internal);
+        }
+        ch.unlock();
+      }
+    }
+    if byLines {
+      forall rec in f.records(style.string_end:uint(8), start, end,
+                              local_style=style) do
+        yield rec;
+    } else {
+      for x in these() do yield x;
+    }
+  }
 }
 
 /* Create and return an :record:`ItemReader` that can yield read values of
@@ -5892,7 +6091,8 @@ proc channel._match_regexp_if_needed(cur:size_t, len:size_t, ref error:syserr,
 //  in readf. (used in the regexp handling here).
 pragma "no doc"
 proc channel._format_reader(
-    fmt:c_string, ref cur:size_t, len:size_t, ref error:syserr,
+    fmt:c_string, plan:qio_conv_plan_ptr_t,
+    ref cur:size_t, len:size_t, ref error:syserr,
     ref conv:qio_conv_t, ref gotConv:bool, ref style:iostyle,
     ref r:unmanaged _channel_regexp_info,
     isReadf:bool)
@@ -5903,7 +6103,7 @@ proc channel._format_reader(
       gotConv = false;
       if error then break;
       var end:uint(64);
-      error = qio_conv_parse(fmt, cur, end, isReadf, conv, style);
+      error = qio_conv_plan_parse(plan, fmt, cur, end, isReadf, conv, style);
       if error {
       }
       cur = end:size_t;
@@ -6328,6 +6528,7 @@ proc channel.writef(fmtStr: string, const args ...?k): bool throws {
     var save_style = this._style();
     var cur:size_t = 0;
     var len:size_t = fmt.length:size_t;
+    var plan = qio_conv_plan_get(fmt, len, 0);
     var conv:qio_conv_t;
     var gotConv:bool;
     var style:iostyle;
@@ -6353,7 +6554,7 @@ proc channel.writef(fmtStr: string, const args ...?k): bool throws {
       gotConv = false;
 
       if j <= i {
-        _format_reader(fmt, cur, len, err,
+        _format_reader(fmt, plan, cur, len, err,
                        conv, gotConv, style, r,
                        false);
       }
@@ -6447,7 +6648,7 @@ proc channel.writef(fmtStr: string, const args ...?k): bool throws {
     if ! err {
       if cur < len {
         var dummy:c_int;
-        _format_reader(fmt, cur, len, err,
+        _format_reader(fmt, plan, cur, len, err,
                        conv, gotConv, style, r,
                        false);
       }
@@ -6492,6 +6693,7 @@ proc channel.writef(fmtStr:string): bool throws {
     var save_style = this._style();
     var cur:size_t = 0;
     var len:size_t = fmt.length:size_t;
+    var plan = qio_conv_plan_get(fmt, len, 0);
     var conv:qio_conv_t;
     var gotConv:bool;
     var style:iostyle;
@@ -6503,7 +6705,7 @@ proc channel.writef(fmtStr:string): bool throws {
       if r then delete r;
     }
 
-    _format_reader(fmt, cur, len, err,
+    _format_reader(fmt, plan, cur, len, err,
                    conv, gotConv, style, r,
                    false);
 
@@ -6567,6 +6769,7 @@ proc channel.readf(fmtStr:string, ref args ...?k): bool throws {
     var save_style = this._style();
     var cur:size_t = 0;
     var len:size_t = fmt.length:size_t;
+    var plan = qio_conv_plan_get(fmt, len, 1);
     var conv:qio_conv_t;
     var gotConv:bool;
     var style:iostyle;
@@ -6591,7 +6794,7 @@ proc channel.readf(fmtStr:string, ref args ...?k): bool throws {
         // we're writing it all in a param for in order to
         // get generic argument handling.
         if j <= i {
-          _format_reader(fmt, cur, len, err,
+          _format_reader(fmt, plan, cur, len, err,
                          conv, gotConv, style, r,
                          true);
 
@@ -6761,7 +6964,7 @@ proc channel.readf(fmtStr:string, ref args ...?k): bool throws {
       if ! err {
         if cur < len {
           var dummy:c_int;
-          _format_reader(fmt, cur, len, err,
+          _format_reader(fmt, plan, cur, len, err,
                          conv, gotConv, style, r,
                          true);
         }
@@ -6823,6 +7026,7 @@ proc channel.readf(fmtStr:string) throws {
     var save_style = this._style();
     var cur:size_t = 0;
     var len:size_t = fmt.length:size_t;
+    var plan = qio_conv_plan_get(fmt, len, 1);
     var conv:qio_conv_t;
     var gotConv:bool;
     var style:iostyle;
@@ -6836,7 +7040,7 @@ proc channel.readf(fmtStr:string) throws {
 
     err = qio_channel_mark(false, _channel_internal);
     if !err {
-      _format_reader(fmt, cur, len, err,
+      _format_reader(fmt, plan, cur, len, err,
                      conv, gotConv, style, r,
                      true);
       if gotConv {
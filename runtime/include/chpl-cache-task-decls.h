@@ -23,6 +23,7 @@
 // This is the type of the task private data used by the cache
 typedef struct {
   int64_t last_acquire; // cache acquire barrier sets this
+  struct rdcache_s* cache; // the (per-pthread) cache last_acquire is from
 } chpl_cache_taskPrvData_t;
 
 #endif
@@ -57,4 +57,35 @@ void chpl_comm_diags_incr(atomic_uint_least64_t* op) {
   (void) atomic_fetch_add_uint_least64_t(op, 1);
 }
 
+
+//
+// The remote data cache keeps its counters in plain (non-atomic)
+// per-pthread structures, since only the owning pthread updates them.
+// These help sum and clear them.
+//
+static inline
+void chpl_cache_diags_reset(chpl_cacheDiagnostics* cd) {
+#define _CACHE_DIAGS_RESET(cdv) cd->cdv = 0;
+  CHPL_CACHE_DIAGS_VARS_ALL(_CACHE_DIAGS_RESET);
+#undef _CACHE_DIAGS_RESET
+}
+
+static inline
+void chpl_cache_diags_add(chpl_cacheDiagnostics* sum,
+                          const chpl_cacheDiagnostics* cd) {
+#define _CACHE_DIAGS_ADD(cdv) sum->cdv += cd->cdv;
+  CHPL_CACHE_DIAGS_VARS_ALL(_CACHE_DIAGS_ADD);
+#undef _CACHE_DIAGS_ADD
+}
+
+
+//
+// Counting comm operations by source line and file, selected at
+// execution time by CHPL_RT_COMM_DIAGS_BY_SITE.  The first is called
+// once comm is fully up and the second once all comm is done; the
+// report is only printed if counting was turned on.
+//
+void chpl_comm_diags_sites_init(void);
+void chpl_comm_diags_sites_report(void);
+
 #endif
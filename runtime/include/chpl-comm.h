@@ -153,6 +153,26 @@ void chpl_comm_wait_nb_some(chpl_comm_nb_handle_t* h, size_t nhandles);
 // detected.
 int chpl_comm_try_nb_some(chpl_comm_nb_handle_t* h, size_t nhandles);
 
+// Do a list of GETs in a nonblocking fashion, returning a single handle
+// which can be used to wait for all of them to complete.  GET i copies
+// sizes[i] bytes from raddrs[i] on nodes[i] to addrs[i].  As with
+// chpl_comm_get_nb, the destination buffers must not be modified before
+// the requests complete.  The argument arrays themselves may be reused
+// as soon as this returns.  The returned handle may be NULL if the GETs
+// have already completed.
+chpl_comm_nb_handle_t chpl_comm_getv(size_t n, void** addrs,
+                                     c_nodeid_t* nodes, void** raddrs,
+                                     size_t* sizes, int32_t typeIndex,
+                                     int32_t commID, int ln, int32_t fn);
+
+// Do a list of PUTs in a nonblocking fashion, like chpl_comm_getv.  PUT i
+// copies sizes[i] bytes from addrs[i] to raddrs[i] on nodes[i].  The
+// source buffers must not be modified before the requests complete.
+chpl_comm_nb_handle_t chpl_comm_putv(size_t n, void** addrs,
+                                     c_nodeid_t* nodes, void** raddrs,
+                                     size_t* sizes, int32_t typeIndex,
+                                     int32_t commID, int ln, int32_t fn);
+
 // Returns whether or not the passed wide address is known to be in
 // a communicable memory region and known to be readable. That is,
 // GET to that address should succeed without an access violation
@@ -514,6 +534,30 @@ typedef struct _chpl_commDiagnostics {
 #undef _COMM_DIAGS_DECL
 } chpl_commDiagnostics;
 
+//
+// Remote data cache diagnostics.  These are counted per pthread by
+// the cache (see chpl-cache.c) while comm diagnostics are enabled, and
+// summed over the pthreads of a locale when they are retrieved.  With
+// no remote data cache they are always zero.
+//
+#define CHPL_CACHE_DIAGS_VARS_ALL(MACRO) \
+  MACRO(get_hits) \
+  MACRO(get_partial_hits) \
+  MACRO(get_misses) \
+  MACRO(readahead_issued) \
+  MACRO(readahead_used) \
+  MACRO(dirty_flushes) \
+  MACRO(ain_evictions) \
+  MACRO(aout_evictions) \
+  MACRO(am_evictions) \
+  MACRO(acquire_invalidations)
+
+typedef struct _chpl_cacheDiagnostics {
+#define _CACHE_DIAGS_DECL(cdv) uint64_t cdv;
+  CHPL_CACHE_DIAGS_VARS_ALL(_CACHE_DIAGS_DECL)
+#undef _CACHE_DIAGS_DECL
+} chpl_cacheDiagnostics;
+
 void chpl_startVerboseComm(void);
 void chpl_stopVerboseComm(void);
 void chpl_startVerboseCommHere(void);
@@ -529,6 +573,8 @@ void chpl_stopCommDiagnosticsHere(void);
 void chpl_gen_stopCommDiagnosticsHere(void);
 void chpl_resetCommDiagnosticsHere(void);
 void chpl_getCommDiagnosticsHere(chpl_commDiagnostics *cd);
+void chpl_resetCacheDiagnosticsHere(void);
+void chpl_getCacheDiagnosticsHere(chpl_cacheDiagnostics *cd);
 
 void* chpl_get_global_serialize_table(int64_t idx);
 
@@ -22,16 +22,35 @@
 #ifndef LAUNCHER
 #include <stdint.h>
 #include "chpltypes.h"
+#include "chpl-atomics.h"
+
+//
+// The privatized object table is two-level: a fixed-size array of
+// pointers to blocks of CHPL_PRIVATIZATION_BLOCK_SIZE slots each.
+// Blocks are allocated as needed and never move or go away, so a slot
+// can be read without locks or fences.
+//
+#define CHPL_PRIVATIZATION_BLOCK_BITS 10
+#define CHPL_PRIVATIZATION_BLOCK_SIZE (1 << CHPL_PRIVATIZATION_BLOCK_BITS)
+#define CHPL_PRIVATIZATION_MAX_BLOCKS (1 << 14)
 
 void chpl_privatization_init(void);
 
+int64_t chpl_newPrivatizedPid(void);
+
 void chpl_newPrivatizedClass(void*, int64_t);
 
 // Implementation is here for performance: getPrivatizedClass can be called
 // frequently, so putting it in a header allows the backend to fully optimize.
-extern void** chpl_privateObjects;
+// The block pointer is loaded relaxed; whoever gave us the pid has already
+// synchronized with the store that installed the block and the object.
+extern atomic_uintptr_t chpl_privateObjects[CHPL_PRIVATIZATION_MAX_BLOCKS];
 static inline void* chpl_getPrivatizedClass(int64_t i) {
-  return chpl_privateObjects[i];
+  void** block = (void**)
+    atomic_load_explicit_uintptr_t(
+        &chpl_privateObjects[i >> CHPL_PRIVATIZATION_BLOCK_BITS],
+        memory_order_relaxed);
+  return block[i & (CHPL_PRIVATIZATION_BLOCK_SIZE - 1)];
 }
 
 void chpl_clearPrivatizedClass(int64_t);
@@ -297,6 +297,18 @@ chpl_task_ChapelData_t* chpl_task_getChapelData(void)
 int chpl_task_supportsRemoteCache(void);
 #endif
 
+//
+// The memory consistency call mentioned above.  A tasking layer that
+// may suspend a task on one pthread and resume it on another, and
+// that says it supports remote caching, must call this at every such
+// point before the task is suspended.  It completes any operations the
+// current pthread's remote data cache has pending on the task's
+// behalf.  (The matching acquire in the new pthread's cache is done by
+// the cache itself, the first time the task uses it.)  This is shared
+// code, in chpl-tasks.c.
+//
+void chpl_task_beforeMigration(void);
+
 //
 // Returns the maximum width of parallelism the tasking layer expects
 // to be able to provide on the calling (sub)locale.  With some
@@ -87,6 +87,29 @@ extern "C" {
 // how large is an iobuf?
 extern size_t qbytes_iobuf_size;
 
+// Released iobufs go to a per-thread pool for reuse, which keeps up to
+// qbytes_iobuf_pool_high of them.  When it would keep more, it frees
+// iobufs until qbytes_iobuf_pool_low are left.  Setting
+// qbytes_iobuf_pool_high to 0 turns the pools off.
+extern ssize_t qbytes_iobuf_pool_high;
+extern ssize_t qbytes_iobuf_pool_low;
+
+typedef struct {
+  uint64_t allocs;    // iobufs allocated
+  uint64_t hits;      // ... of which were taken from a pool
+  uint64_t releases;  // iobufs released to a pool
+  uint64_t trimmed;   // ... of which were later freed by a pool
+  int64_t pooled;     // iobufs in pools now
+} qbytes_iobuf_pool_stats_t;
+
+// Sum the statistics of all of the iobuf pools.  This is only
+// approximate while other threads are using their pools.
+void qbytes_iobuf_pool_stats(qbytes_iobuf_pool_stats_t* stats);
+
+// Free the pooled iobufs and stop pooling.  Call only once no other
+// threads are using iobufs.
+void qbytes_iobuf_pool_exit(void);
+
 struct qbytes_s;
 
 // a free function
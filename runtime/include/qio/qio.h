@@ -203,12 +203,26 @@ typedef qio_fdflag_t fdflag_t;
 
 
 // make a re-entrant lock.
+//
+// A lock can also be biased toward the first task that takes it, see
+// qio_lock_init_biased. That task then takes and releases it without
+// touching sv, until some other task wants it and revokes the bias.
 typedef struct {
   chpl_sync_aux_t sv;
   chpl_taskID_t owner; // task ID of owner.
   uint64_t count; // how many times owner has locked.
+  volatile int bias_state; // one of QIO_BIAS_*
+  chpl_taskID_t bias_owner; // task the lock is biased toward
+  volatile uint64_t bias_count; // how many times bias_owner has locked.
 } qio_lock_t;
 
+enum {
+  QIO_BIAS_OFF = 0,       // plain re-entrant lock
+  QIO_BIAS_UNCLAIMED = 1, // biased toward the next task to lock it
+  QIO_BIAS_HELD = 2,      // biased toward bias_owner
+  QIO_BIAS_REVOKING = 3,  // being taken away from bias_owner
+};
+
 #define NULL_OWNER chpl_nullTaskID
 
 #ifdef __cplusplus
@@ -218,13 +232,25 @@ extern "C" {
 qioerr qio_lock(qio_lock_t* x);
 void qio_unlock(qio_lock_t* x);
 
+// Whether locks can be biased on this system; see qio.c.
+int qio_lock_bias_available(void);
+
 static inline qioerr qio_lock_init(qio_lock_t* x) {
   x->owner = NULL_OWNER;
   x->count = 0;
+  x->bias_state = QIO_BIAS_OFF;
+  x->bias_owner = NULL_OWNER;
+  x->bias_count = 0;
   chpl_sync_initAux(&x->sv);
   return 0;
 }
 
+static inline qioerr qio_lock_init_biased(qio_lock_t* x) {
+  qioerr err = qio_lock_init(x);
+  if( ! err && qio_lock_bias_available() ) x->bias_state = QIO_BIAS_UNCLAIMED;
+  return err;
+}
+
 static inline void qio_lock_destroy(qio_lock_t* x) {
   chpl_sync_destroyAux(&x->sv);
 }
@@ -277,6 +303,10 @@ static inline qioerr qio_lock_init(qio_lock_t* x) {
 // returns void for the same reason as qio_unlock.
 static inline void qio_lock_destroy(qio_lock_t* x) { int rc = pthread_mutex_destroy(x); if( rc ) { assert(rc == 0); abort(); } }
 
+static inline qioerr qio_lock_init_biased(qio_lock_t* x) {
+  return qio_lock_init(x);
+}
+
 #ifdef __cplusplus
 } // end extern "C"
 #endif
@@ -287,6 +317,8 @@ static inline void qio_lock_destroy(qio_lock_t* x) { int rc = pthread_mutex_dest
 extern ssize_t qio_too_small_for_default_mmap;
 extern ssize_t qio_too_large_for_default_mmap;
 extern ssize_t qio_mmap_chunk_iobufs;
+extern ssize_t qio_mmap_min_chunk_iobufs;
+extern ssize_t qio_uring_readahead_iobufs;
 
 #ifdef __cplusplus
 extern "C" {
@@ -348,13 +380,14 @@ typedef enum {
   QIO_METHOD_FREADFWRITE = 3*QIO_HINT_AFTERCHTYPE,
   QIO_METHOD_MMAP = 4*QIO_HINT_AFTERCHTYPE,
   QIO_METHOD_MEMORY = 5*QIO_HINT_AFTERCHTYPE,
+  QIO_METHOD_URING = 6*QIO_HINT_AFTERCHTYPE,
   //QIO_METHOD_LIBEVENT,
 } qio_method_t;
 #define QIO_METHODMASK 0x00f0
 #define QIO_HINT_AFTERMETHOD 0x0100
 #define QIO_METHOD_DEFAULT 0
 #define QIO_MIN_METHOD QIO_METHOD_READWRITE
-#define QIO_MAX_METHOD QIO_METHOD_MEMORY
+#define QIO_MAX_METHOD QIO_METHOD_URING
 
 enum {
   QIO_HINT_RANDOM       = QIO_HINT_AFTERMETHOD,
@@ -449,6 +482,9 @@ char* qio_hints_to_string(qio_hint_t hint)
       case QIO_METHOD_MEMORY:
         strcat(buf, " memory"); ok = 1;
         break;
+      case QIO_METHOD_URING:
+        strcat(buf, " uring"); ok = 1;
+        break;
       // no default to get warned if any are added.
     }
   }
@@ -470,6 +506,15 @@ char* qio_hints_to_string(qio_hint_t hint)
 }
 #endif
 
+// A window of a file mapped by a QIO_METHOD_MMAP channel.
+typedef struct {
+  qbytes_t* bytes; // the mapping, or NULL
+  int64_t start;   // file offset of bytes->data
+} qio_mmap_window_t;
+
+// How many read-only windows each file keeps for reuse.
+#define QIO_MMAP_WINDOWS 8
+
 typedef struct qio_file_s {
   // reference count which is atomically updated
   qbytes_refcnt_t ref_cnt;
@@ -537,6 +582,12 @@ typedef struct qio_file_s {
   qio_lock_t lock;
   int64_t max_initial_position;
 
+  // The read-only windows most recently mapped by channels on this
+  // file, most recent first, so that channels hopping around the file
+  // can reuse them.  Windows that no channel is using are dropped
+  // whenever a reading channel is closed.  Protected by lock.
+  qio_mmap_window_t mmap_windows[QIO_MMAP_WINDOWS];
+
   qio_style_t style;
 } qio_file_t;
 
@@ -547,6 +598,12 @@ qioerr qio_writev(qio_file_t* file, qbuffer_t* buf, qbuffer_iter_t start, qbuffe
 qioerr qio_preadv(qio_file_t* file, qbuffer_t* buf, qbuffer_iter_t start, qbuffer_iter_t end, int64_t seek_to_offset, ssize_t* num_read);
 qioerr qio_pwritev(qio_file_t* file, qbuffer_t* buf, qbuffer_iter_t start, qbuffer_iter_t end, int64_t seek_to_offset, ssize_t* num_written);
 
+// preadv/pwritev through io_uring, for QIO_METHOD_URING. These fall
+// back to qio_preadv/qio_pwritev when io_uring can't be used.
+int qio_uring_available(void);
+qioerr qio_uring_preadv(qio_file_t* file, qbuffer_t* buf, qbuffer_iter_t start, qbuffer_iter_t end, int64_t seek_to_offset, ssize_t* num_read);
+qioerr qio_uring_pwritev(qio_file_t* file, qbuffer_t* buf, qbuffer_iter_t start, qbuffer_iter_t end, int64_t seek_to_offset, ssize_t* num_written);
+
 // if fp is not null, fd is ignored; if fp is null, we use fd.
 // the QIO file takes ownership of fp or fd, closing it when the QIO file is closed.
 qioerr qio_file_init(qio_file_t** file_out, FILE* fp, fd_t fd, qio_hint_t iohints, const qio_style_t* style, int usefilestar);
@@ -759,6 +816,11 @@ typedef struct qio_channel_s {
   qio_hint_t hints;
   qio_fdflag_t flags;
 
+  // For QIO_METHOD_MMAP: where the last window mapped for this channel
+  // ended (-1 if none yet), and the size of that window.
+  int64_t mmap_next_pos;
+  int64_t mmap_window;
+
   // buffered channel materials.
   /* When reading, we 'require' then read from
    * right_mark_start to (potentially) heavy->av_end
@@ -827,6 +827,18 @@ void qio_conv_destroy(qio_conv_t* spec);
 void qio_conv_init(qio_conv_t* spec_out);
 qioerr qio_conv_parse(c_string fmt, size_t start, uint64_t* end_out, int scanning, qio_conv_t* spec_out, qio_style_t* style_out);
 
+// A format string parsed once and kept for reuse by later calls
+// with the same format; see qio_conv_plan_get.
+typedef struct qio_conv_plan_s qio_conv_plan_t;
+typedef qio_conv_plan_t* qio_conv_plan_ptr_t;
+
+// Returns the cached plan for this format string, creating it if need be.
+// Returns NULL if the string can't be cached; qio_conv_plan_parse
+// then parses it as qio_conv_parse would.
+qio_conv_plan_t* qio_conv_plan_get(c_string fmt, size_t len, int scanning);
+// Like qio_conv_parse, but uses the plan's result when it has one.
+qioerr qio_conv_plan_parse(qio_conv_plan_t* plan, c_string fmt, size_t start, uint64_t* end_out, int scanning, qio_conv_t* spec_out, qio_style_t* style_out);
+
 // These error codes can be used by callers to qio_conv_parse
 qioerr qio_format_error_too_many_args(void);
 qioerr qio_format_error_too_few_args(void);
@@ -79,11 +79,21 @@ typedef pthread_cond_t chpl_thread_condvar_t;
 //
 // Sync variables
 //
+// On Linux, waiters that have to park do so on a futex word that is
+// bumped each time the variable becomes full (full_seq) or empty
+// (empty_seq).  Elsewhere they park on the condition variables.  The
+// waiter counts tell the signaler whether anyone needs waking.  All
+// but is_full are protected by the lock.
+//
 typedef struct {
   volatile chpl_bool  is_full;
   chpl_thread_mutex_t lock;
   chpl_thread_condvar_t signal_full;  // wait for full; signal this when full
   chpl_thread_condvar_t signal_empty; // wait for empty; signal this when empty
+  volatile uint32_t   full_seq;       // futex word: bumped when made full
+  volatile uint32_t   empty_seq;      // futex word: bumped when made empty
+  int32_t             full_waiters;   // number parked waiting for full
+  int32_t             empty_waiters;  // number parked waiting for empty
   //  threadlayer_sync_aux_t tl_aux;
 } chpl_sync_aux_t;
 
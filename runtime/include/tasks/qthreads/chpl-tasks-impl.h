@@ -106,6 +106,13 @@ extern pthread_t chpl_qthread_comm_pthread;
 extern chpl_qthread_tls_t chpl_qthread_process_tls;
 extern chpl_qthread_tls_t chpl_qthread_comm_task_tls;
 
+// Set at startup when the scheduler can move tasks between pthreads
+// but the remote data cache should be usable anyway.  Then every point
+// where a task may move has to call chpl_task_beforeMigration(), which
+// is declared in chpl-tasks.h (after this file is included).
+extern int chpl_qthread_cache_task_migration;
+void chpl_task_beforeMigration(void);
+
 #define CHPL_TASK_STD_MODULES_INITIALIZED chpl_task_stdModulesInitialized
 void chpl_task_stdModulesInitialized(void);
 
@@ -226,6 +233,8 @@ void chpl_task_setSubloc(c_sublocid_t full_subloc)
 
         if (execution_subloc != c_sublocid_any &&
             (qthread_shepherd_id_t) execution_subloc != curr_shep) {
+            if (chpl_qthread_cache_task_migration)
+                chpl_task_beforeMigration();
             qthread_migrate_to((qthread_shepherd_id_t) execution_subloc);
         }
     }
@@ -241,7 +250,8 @@ void chpl_task_setSubloc(c_sublocid_t full_subloc)
 #endif
 static inline
 int chpl_task_supportsRemoteCache(void) {
-  return CHPL_QTHREAD_SUPPORTS_REMOTE_CACHE;
+  return CHPL_QTHREAD_SUPPORTS_REMOTE_CACHE
+         || chpl_qthread_cache_task_migration;
 }
 
 #ifdef __cplusplus
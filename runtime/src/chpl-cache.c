@@ -158,10 +158,10 @@ remote address. The pointer tree uses separate chaining (ie, each hash table
 element is actually a linked list of elements that go into that bucket).
 
 The cache consists of 'cache entries', one per 'cache page'. A 'cache page' is
-1024 bytes in the current implementation. The pointer tree and the 2Q queues
-consist of cache entries which may point to a 1024-byte cache page. However, a
-GET is always rounded up to entire 'cache line'. A cache line is currently 64
-bytes. Each cache entry tracks which cache lines are valid (ie, for which cache
+1024 bytes by default. The pointer tree and the 2Q queues
+consist of cache entries which may point to a cache page. However, a
+GET is always rounded up to entire 'cache line'. A cache line is 64
+bytes by default. Each cache entry tracks which cache lines are valid (ie, for which cache
 lines in the cache page have we done a GET?) and for pages that have been
 written to in a PUT - aka 'dirty pages' - which bytes in the page have been
 written to.
@@ -174,11 +174,23 @@ There is a tradeoff in the cache line size and in the cache page size:
     (since read ahead/write behind will only ever get a single cache page
      in one operation).
 
-We chose 64 bytes for the cache line size because on our Infiniband network, 64
-bytes is the largest request size which has no significant increase in latency
-from an 8 byte request. We chose 1024 bytes for the cache page size because it
-is the smallest request size that allows close to peak bandwidth in our
-network.
+We chose 64 bytes for the default cache line size because on our Infiniband
+network, 64 bytes is the largest request size which has no significant
+increase in latency from an 8 byte request. We chose 1024 bytes for the
+default cache page size because it is the smallest request size that allows
+close to peak bandwidth in our network. Other networks have different
+tradeoffs, so the page size, line size, readahead window and cache size can
+be changed at program start with these environment variables:
+
+  CHPL_RT_CACHE_PAGE_SIZE       cache page size (64 bytes .. 4k bytes)
+  CHPL_RT_CACHE_LINE_SIZE       cache line size (64 bytes .. page size)
+  CHPL_RT_CACHE_READAHEAD_PAGES maximum pages per prefetch/readahead
+  CHPL_RT_CACHE_SIZE            size of the data area of each cache
+
+When processing GETs that are a constant stride apart but not adjacent
+(e.g. reading a column of a row-major array), a stride prefetcher keyed
+by the GET's call site starts nonblocking GETs a few strides ahead. The
+distance can be changed with CHPL_RT_CACHE_STRIDE_PREFETCH_DISTANCE.
 
 When processing a GET, we first check to see if the requested cache page is
 in the pointer tree. If not, we find an unused cache page and immediately start
@@ -244,46 +256,59 @@ the sequence number of the last acquire barrier. If a task performs a GET but
 finds a cache entry with a minimum sequence number before its last acquire
 barrier, it must invalidate that cache line and do a new GET.
 
-Lastly, since the implementation uses thread-local storage for the cache, it
-requires that tasks not move between threads. Tasks could move between threads
-if we had a way to notify the cache that they were about to do so (in which
-case the cache would issue a release barrier in the old thread and an acquire
-barrier in the new thread). Another alternative would be to mark tasks with
-ongoing operations in the cache as not movable to other threads. A third option
-would be to only move tasks between threads in situations that create full
-barriers anyway; notably a full barrier occurs on task start and sync variable
-use.
+Lastly, since the implementation uses thread-local storage for the cache, a
+task must not leave a thread with operations still pending in that thread's
+cache on its behalf. Tasking layers that never move tasks between threads get
+this for free. Tasking layers that do move tasks (work stealing, or multiple
+workers sharing a run queue) call chpl_task_beforeMigration() at each point
+where the running task may be suspended and later resumed elsewhere; that
+issues a release barrier in the old thread's cache. The acquire barrier in
+the new thread happens lazily: each task records which cache its last acquire
+sequence number came from, and the first time it uses a different cache it
+takes a fresh acquire there (sequence numbers from one cache mean nothing in
+another).
 
  */
 
-// ASSUMES THAT TASKS DO NOT MIGRATE BETWEEN PTHREADS
-// because:
+// Tasks may only migrate between pthreads at points where the tasking
+// layer calls chpl_task_beforeMigration(), because:
 // 1) GASNet handles are only valid for a specific pthread
 // 2) want to avoid synchronization on the cache data structures
 //    but don't want to have 1 per task.
 //
-// If (1) is resolved, we could also weaken (2) by detecting
-// when task-local storage != thread-local storage.
+// The release done there leaves nothing pending on the task's behalf in
+// the old pthread's cache, which handles (1) and (2), and
+// task_private_cache_data() detects when task-local storage no longer
+// matches thread-local storage and re-bases the task's last acquire.
+// This relies on a task never moving while it is in the middle of a
+// cache operation; the comm layers guarantee that today, because they
+// don't yield the task while waiting on the cache's nonblocking ops
+// (GASNet blocks, and ugni keeps its pthread while holding a comm domain).
 //
 // See chapel-developers thread "migrating tasks" from 9/25/2013.
 // FIFO: never moves a task from one pthread to another
 // massivethreads: may move a task with sync/wait/yield/etc
-// Qthreads workaround: QT_NUM_WORKERS_PER_SHEPHERD=1
-//   (on 9/26/2013 Dylan mentioned perhaps adding 'pin to worker')
+//   (and does not call the hook, so it still reports no cache support)
+// Qthreads: nemesis and the other one-worker-per-shepherd schedulers
+//   never move tasks; the others do, and support the cache only when
+//   CHPL_RT_CACHE_TASK_MIGRATION is set, which turns the hook on.
 
 #include "chplrt.h"
 #include "chpl-comm.h"
+#include "chpl-comm-diags.h"
 #include "chpl-tasks.h"
 #include "chpl-mem.h"
 #include "chpl-atomics.h"
 #include "chpl-thread-local-storage.h" // CHPL_TLS_DECL etc
 #include "chpl-cache.h"
+#include "chpl-env.h"
 #include "chpl-linefile-support.h"
 #include "sys.h" // sys_page_size()
 #include "chpl-comm-compiler-macros.h"
 #include "chpl-comm-no-warning-macros.h" // No warnings for chpl_comm_get etc.
 #include <string.h> // memcpy, memset, etc.
 #include <assert.h>
+#include <pthread.h>
 
 
 #ifdef HAS_CHPL_CACHE_FNS
@@ -294,45 +319,77 @@ use.
 
 // We try to auto-size the cache so that we
 // can have CACHE_PAGES_PER_NODE cache pages per locale, but we
-// do so within the below bounds.
+// do so within the below bounds.  CHPL_RT_CACHE_SIZE overrides
+// this and gives the size in bytes of the data area of each cache.
 #define CACHE_PAGES_PER_NODE 4
 #define MIN_CACHE_DATA_SIZE (1024*1024)
 #define MAX_CACHE_DATA_SIZE (256*1024*1024)
+// Never use fewer than this many pages, whatever CHPL_RT_CACHE_SIZE says.
+#define MIN_CACHE_PAGES 64
 
 // How many pending operations can we have at once?
 #define MAX_PENDING 32
 
-// CACHEPAGE_BITS 
+// The cache geometry (page size, line size, readahead window and
+// overall size) is chosen once at program start, in
+// chpl_cache_init_geometry(), from these defaults and from the
+// CHPL_RT_CACHE_* environment variables. The defaults were chosen
+// for an Infiniband network (see Implementation Notes above); other
+// networks might do better with different values.
+//
+// The upper-case names below used to be compile-time constants; they
+// now refer to the geometry chosen at startup, but are otherwise used
+// in the same way.
+struct cache_geometry_s {
+  int page_bits;
+  int line_bits;
+  int pages_per_prefetch;
+  int stride_prefetch_distance; // 0 disables the stride prefetcher
+  size_t data_size; // 0 means auto-size
+  // These are derived from the above
+  int low_other_bits;
+  int high_other_bits;
+};
+
+static struct cache_geometry_s cache_geometry;
+
+// CACHEPAGE_BITS
 // Controls the cache page size - the cache manages items of this many bytes
 // but also includes facilities for partial pages (valid and dirty bits).
 //
-// Reasonable values for CACHEPAGE_BITS are between 6 and 12
-// (64 bytes and 4k bytes. CACHEPAGE_BITS should not be larger than the
-// page size) and it must currently be even.
-// Here we set it to 1k bytes (ie 2^10).
-#define CACHEPAGE_BITS 10
+// CHPL_RT_CACHE_PAGE_SIZE can be used to set it to a power of 2 between
+// MIN_CACHEPAGE_BITS and MAX_CACHEPAGE_BITS (64 bytes and 4k bytes).
+// It will also be limited to the system page size.
+// By default we set it to 1k bytes (ie 2^10).
+#define DEFAULT_CACHEPAGE_BITS 10
+#define MIN_CACHEPAGE_BITS 6
+#define MAX_CACHEPAGE_BITS 12
+#define CACHEPAGE_BITS (cache_geometry.page_bits)
 #define CACHEPAGE_SIZE (1 << CACHEPAGE_BITS)
 #define CACHEPAGE_MASK (CACHEPAGE_SIZE-1)
 
-// CACHELINE_BITS 
+// CACHELINE_BITS
 // Controls the cache line size - that is, the minimum number of bytes
 // that are fetched for any 'get' operation.
 //
-// Reasonable values for CACHELINE_BITS are between 6 and CACHEPAGE_BITS.
-// Here we set it to 64 bytes (ie 2^6)
-#define CACHELINE_BITS 6
+// CHPL_RT_CACHE_LINE_SIZE can be used to set it to a power of 2 between
+// MIN_CACHELINE_BITS and CACHEPAGE_BITS.
+// By default we set it to 64 bytes (ie 2^6)
+#define DEFAULT_CACHELINE_BITS 6
+#define MIN_CACHELINE_BITS 6
+#define CACHELINE_BITS (cache_geometry.line_bits)
 #define CACHELINE_SIZE (1 << CACHELINE_BITS)
 #define CACHELINE_MASK (CACHELINE_SIZE-1)
 
-// What type can store the number of cache lines in a cache page?
-typedef int8_t line_per_page_t; 
 // What type for a number of lines to read ahead?
-typedef int16_t readahead_distance_t;
+typedef int32_t readahead_distance_t;
 
 // When prefetching, what is the maximum number of pages
 // we are willing to prefetch? This is also the maximum
 // readahead window size for sequential access.
-#define MAX_PAGES_PER_PREFETCH 2
+// CHPL_RT_CACHE_READAHEAD_PAGES can be used to change it.
+#define DEFAULT_PAGES_PER_PREFETCH 2
+#define MAX_PAGES_PER_PREFETCH (cache_geometry.pages_per_prefetch)
 
 // Should we enable sequential readahead?
 // For sequential access If we're reading  
@@ -341,6 +398,25 @@ typedef int16_t readahead_distance_t;
 #define ENABLE_READAHEAD_TRIGGER_SEQUENTIAL 0
 #define MAX_SEQUENTIAL_READAHEAD_BYTES (MAX_PAGES_PER_PREFETCH*CACHEPAGE_SIZE)
 
+// Should we enable the stride prefetcher?
+// Sequential readahead only helps when consecutive GETs touch adjacent
+// memory. The stride prefetcher is modeled on a hardware reference
+// prediction table: GETs are grouped by call site (ln, fn) - the
+// closest thing we have to a program counter - and when a call site
+// keeps reading at a constant stride, we start nonblocking GETs for
+// the next few elements of that stream. This covers e.g. walking a
+// column of a row-major array.
+#define ENABLE_STRIDE_PREFETCH 1
+// How many entries are in the stride prediction table? (power of 2)
+#define STRIDE_TABLE_SIZE 64
+// How many times in a row must a stride repeat before we prefetch?
+#define STRIDE_PREFETCH_CONFIDENCE 2
+// How many strides ahead of the current access do we prefetch?
+// CHPL_RT_CACHE_STRIDE_PREFETCH_DISTANCE can be used to change it.
+#define DEFAULT_STRIDE_PREFETCH_DISTANCE 4
+#define MAX_STRIDE_PREFETCH_DISTANCE 32
+#define STRIDE_PREFETCH_DISTANCE (cache_geometry.stride_prefetch_distance)
+
 //#define TIME
 //#define TRACE
 //#define DEBUG
@@ -390,6 +466,12 @@ static long time_duration(const struct timespec* t1, const struct timespec* t2)
 
 
 
+// Count a cache event in the cache diagnostics, if they are enabled.
+// Each pthread has its own cache and counters, so no atomics are needed.
+#define CACHE_DIAGS_INCR(cache, cdv) \
+  do { if (chpl_comm_diagnostics) (cache)->diags.cdv++; } while(0)
+
+
 // ----------  SUPPORT FUNCTIONS 
 #include "chpl-cache-support.c"
 
@@ -402,7 +484,7 @@ struct rdcache_s;
 
 //////////////// REMOTE DATA CACHE IMPLEMENTATION ////////////////////
 
-/*     (big endian diagram)
+/*     (big endian diagram, for the default 1k cache page size)
 
    |            64-bit address ^ (node_number << 32)                    |
    +---------------------------------------------------------------------+
@@ -428,16 +510,23 @@ struct rdcache_s;
    
    Attempts to read a byte from the cache which is not valid results in
    failure.
+
+   The number of "other" bits in each half depends on the cache page
+   size chosen at startup. When 64-TOP_BITS-BOTTOM_BITS-CACHEPAGE_BITS
+   is odd, the top half gets the extra bit.
 */
 
 #define TOP_BITS 10
 #define BOTTOM_BITS 10
-#define OTHER_BITS ((64-TOP_BITS-BOTTOM_BITS-CACHEPAGE_BITS)/2)
-#define HALF_BITS (TOP_BITS+OTHER_BITS)
+#define LOW_OTHER_BITS (cache_geometry.low_other_bits)
+#define HIGH_OTHER_BITS (cache_geometry.high_other_bits)
+#define LOW_HALF_BITS (BOTTOM_BITS+LOW_OTHER_BITS)
+#define HIGH_HALF_BITS (TOP_BITS+HIGH_OTHER_BITS)
 
 #define TOP_SIZE (1 << TOP_BITS)
 #define BOTTOM_SIZE (1 << BOTTOM_BITS)
-#define HALF_SIZE (1L << HALF_BITS)
+#define LOW_HALF_SIZE (1L << LOW_HALF_BITS)
+#define HIGH_HALF_SIZE (1L << HIGH_HALF_BITS)
 
 // How many uint64_t words do we need to create a bitmask for CACHEPAGE_SIZE?
 // Divide # bytes in cache by 64, rounding up.
@@ -446,9 +535,13 @@ struct rdcache_s;
 // How many cache lines per cache page?
 #define CACHE_LINES_PER_PAGE (CACHEPAGE_SIZE/CACHELINE_SIZE)
 
-// How many uint64_t words do we need to create a bitmask for CACHE_LINES_PER_PAGE
-// ie, a mask recording a bit per cache line?
-#define CACHE_LINES_PER_PAGE_BITMASK_WORDS (((CACHEPAGE_SIZE/CACHELINE_SIZE)+63)/64)
+// How many uint64_t words do we need to create a bitmask for
+// CACHE_LINES_PER_PAGE, ie, a mask recording a bit per cache line?
+// This is sized for the largest number of lines per page that the
+// geometry allows; bits for lines beyond CACHE_LINES_PER_PAGE are
+// never set.
+#define CACHE_LINES_PER_PAGE_BITMASK_WORDS \
+  (((1 << (MAX_CACHEPAGE_BITS-MIN_CACHELINE_BITS))+63)/64)
 
 struct cache_entry_base_s {
   uint32_t index_bits;
@@ -471,7 +564,8 @@ struct dirty_entry_s {
   // which cache entry are we talking about here?
   struct cache_entry_s* entry;
   // Which of the page's bytes are dirty?
-  uint64_t dirty[CACHEPAGE_BITMASK_WORDS]; // ie we need to create a put for these bytes
+  // This points to CACHEPAGE_BITMASK_WORDS words allocated in cache_create.
+  uint64_t* dirty; // ie we need to create a put for these bytes
 };
 
 #define QUEUE_FREE 0
@@ -501,6 +595,9 @@ struct cache_entry_s {
   // Readahead information.
   readahead_distance_t readahead_skip;
   readahead_distance_t readahead_len; // == 0 if this page doesn't trigger readahead.
+  // Has a prefetch brought in data that no GET has used yet?
+  // (only used for cache diagnostics)
+  int prefetched_unused;
   // These are the queue links. Am is LRU but Ain and Aout are FIFO
   struct cache_entry_s* next; // next entry in Ain/Aout/Am
   struct cache_entry_s* prev; // previous entry in An/Aout/Am
@@ -567,6 +664,22 @@ struct top_entry_s {
   struct cache_entry_s* bottom_index[BOTTOM_SIZE];
 };
 
+// One stream in the stride prediction table.
+struct stride_entry_s {
+  // Which call site and node does this entry track?
+  int32_t fn;
+  int ln;
+  c_nodeid_t node;
+  // Address of the last GET from this call site (0 if the entry is unused)
+  raddr_t last_raddr;
+  // Difference between the last two GET addresses
+  intptr_t stride;
+  // How many times in a row have we seen this stride?
+  int confidence;
+  // Furthest address we have already prefetched along this stream
+  raddr_t prefetched_raddr;
+};
+
 struct rdcache_s {
   // A 2Q cache.
   // See "2Q: A Low Overhead High Performance Buffer Management
@@ -665,6 +778,15 @@ struct rdcache_s {
   int max_top_entries;
   struct cache_entry_base_s* free_top_nodes_head; // a linked list.
 
+  // Stride prediction table, indexed by a hash of the call site.
+  struct stride_entry_s stride_table[STRIDE_TABLE_SIZE];
+
+  // Diagnostic counters for this cache. Only the owning pthread
+  // updates these; see chpl_getCacheDiagnosticsHere.
+  chpl_cacheDiagnostics diags;
+  // Link in the list of all caches on this locale.
+  struct rdcache_s* next_cache;
+
   // The entry into the 'pointer tree' hashtable structure.
   struct top_entry_s* top_index_list[TOP_SIZE];
 };
@@ -685,6 +807,7 @@ struct rdcache_s* cache_create(void) {
   struct page_list_s* page_list_entries = NULL;
   struct cache_entry_s *entries = NULL;
   struct dirty_entry_s *dirty_nodes = NULL;
+  uint64_t *dirty_bits = NULL;
   uintptr_t offset;
 
   size_t total_size = 0;
@@ -693,11 +816,17 @@ struct rdcache_s* cache_create(void) {
   unsigned char* buffer;
   unsigned char* pages;
 
-  cache_pages = CACHE_PAGES_PER_NODE * chpl_numNodes;
-  if( cache_pages < MIN_CACHE_DATA_SIZE/CACHEPAGE_SIZE )
-    cache_pages = MIN_CACHE_DATA_SIZE/CACHEPAGE_SIZE;
-  if( cache_pages > MAX_CACHE_DATA_SIZE/CACHEPAGE_SIZE )
-    cache_pages = MAX_CACHE_DATA_SIZE/CACHEPAGE_SIZE;
+  if( cache_geometry.data_size != 0 ) {
+    cache_pages = cache_geometry.data_size / CACHEPAGE_SIZE;
+    if( cache_pages < MIN_CACHE_PAGES )
+      cache_pages = MIN_CACHE_PAGES;
+  } else {
+    cache_pages = CACHE_PAGES_PER_NODE * chpl_numNodes;
+    if( cache_pages < MIN_CACHE_DATA_SIZE/CACHEPAGE_SIZE )
+      cache_pages = MIN_CACHE_DATA_SIZE/CACHEPAGE_SIZE;
+    if( cache_pages > MAX_CACHE_DATA_SIZE/CACHEPAGE_SIZE )
+      cache_pages = MAX_CACHE_DATA_SIZE/CACHEPAGE_SIZE;
+  }
 
   ain_pages = cache_pages / 4; // 2Q: "Kin should be 25% of page slots"
   aout_pages = cache_pages / 2; // 2Q: "Kout should hold identifiers for as
@@ -714,6 +843,7 @@ struct rdcache_s* cache_create(void) {
   total_size += sizeof(struct page_list_s) * cache_pages;
   total_size += sizeof(struct cache_entry_s) * n_entries;
   total_size += sizeof(struct dirty_entry_s) * dirty_pages;
+  total_size += sizeof(uint64_t) * CACHEPAGE_BITMASK_WORDS * dirty_pages;
   total_size += sizeof(chpl_comm_nb_handle_t) * pending_len;
   total_size += sizeof(cache_seqn_t) * pending_len;
   total_size += sizeof(struct top_entry_s) * top_entries;
@@ -737,6 +867,9 @@ struct rdcache_s* cache_create(void) {
   // dirty entries
   dirty_nodes = (struct dirty_entry_s*) (buffer + total_size);
   total_size += sizeof(struct dirty_entry_s) * dirty_pages;
+  // dirty bitmasks
+  dirty_bits = (uint64_t*) (buffer + total_size);
+  total_size += sizeof(uint64_t) * CACHEPAGE_BITMASK_WORDS * dirty_pages;
   // and the pending data area
   c->pending = (chpl_comm_nb_handle_t*) (buffer + total_size);
   total_size += sizeof(chpl_comm_nb_handle_t) * pending_len;
@@ -825,6 +958,7 @@ struct rdcache_s* cache_create(void) {
     dirty_nodes[i].next = next;
     dirty_nodes[i].prev = prev;
     dirty_nodes[i].entry = NULL;
+    dirty_nodes[i].dirty = dirty_bits + i * CACHEPAGE_BITMASK_WORDS;
   }
   c->dirty_lru_tail = &dirty_nodes[dirty_pages-1];
 
@@ -848,6 +982,13 @@ struct rdcache_s* cache_create(void) {
   // clear top_index_list.
   memset(&c->top_index_list[0], 0, sizeof(struct top_entry_s*) * TOP_SIZE);
 
+  // clear the stride prediction table.
+  memset(&c->stride_table[0], 0,
+         sizeof(struct stride_entry_s) * STRIDE_TABLE_SIZE);
+
+  chpl_cache_diags_reset(&c->diags);
+  c->next_cache = NULL;
+
   if( VERIFY ) validate_cache(c);
 
   return c;
@@ -950,7 +1091,7 @@ int get_top_bits(raddr_t raddr, int32_t node) {
   uint64_t val;
 
   val = raddr;
-  val = val >> (HALF_BITS + CACHEPAGE_BITS);
+  val = val >> (LOW_HALF_BITS + CACHEPAGE_BITS);
   val ^= (node & 0xaaaaaaaa); // spread node variation between top and bottom
   val &= (TOP_SIZE-1);
 
@@ -968,12 +1109,12 @@ int get_bottom_bits(raddr_t raddr, int32_t node) {
 static
 uint32_t get_high_bits(raddr_t raddr) {
   uint64_t val = raddr;
-  return (val >> (HALF_BITS + CACHEPAGE_BITS)) & (HALF_SIZE-1);
+  return (val >> (LOW_HALF_BITS + CACHEPAGE_BITS)) & (HIGH_HALF_SIZE-1);
 }
 
 static
 uint32_t get_low_bits(raddr_t raddr) {
-  return (raddr >> CACHEPAGE_BITS) & (HALF_SIZE-1);
+  return (raddr >> CACHEPAGE_BITS) & (LOW_HALF_SIZE-1);
 }
 
 static
@@ -1129,6 +1270,7 @@ void aout_evict(struct rdcache_s* cache)
   // Remove the tail element from Aout
   DOUBLE_REMOVE_TAIL(cache, aout);
   cache->aout_current--;
+  CACHE_DIAGS_INCR(cache, aout_evictions);
 
   // Remove entry (which we are kicking off of Aout) from the tree
   tree_remove(cache, z);
@@ -1170,6 +1312,7 @@ void ain_evict(struct rdcache_s* cache, struct cache_entry_s* dont_evict_me)
 
   DOUBLE_REMOVE_TAIL(cache, ain);
   cache->ain_current--;
+  CACHE_DIAGS_INCR(cache, ain_evictions);
 
   y->queue = QUEUE_AOUT;
 
@@ -1208,6 +1351,7 @@ void am_evict(struct rdcache_s *cache, struct cache_entry_s* dont_evict_me) {
 
   DOUBLE_REMOVE_TAIL(cache, am_lru);
   cache->am_current--;
+  CACHE_DIAGS_INCR(cache, am_evictions);
 
   // Remove this entry in Am from the pointer tree.
   tree_remove(cache, y);
@@ -1741,6 +1885,7 @@ void flush_entry(struct rdcache_s* cache, struct cache_entry_s* entry, int op,
 
           // Save the handle in the list of pending requests.
           entry->max_put_sequence_number = pending_push(cache, handle);
+          CACHE_DIAGS_INCR(cache, dirty_flushes);
 
           // Move past this region of 1s in dirty bits.
           start = got_skip + got_len;
@@ -1776,6 +1921,7 @@ void flush_entry(struct rdcache_s* cache, struct cache_entry_s* entry, int op,
     if( len == CACHEPAGE_SIZE ) {
       entry->readahead_skip = 0;
       entry->readahead_len = 0;
+      entry->prefetched_unused = 0;
       entry->min_sequence_number = NO_SEQUENCE_NUMBER;
       entry->max_put_sequence_number = NO_SEQUENCE_NUMBER;
       entry->max_prefetch_sequence_number = NO_SEQUENCE_NUMBER;
@@ -1878,6 +2024,7 @@ struct cache_entry_s* make_entry(struct rdcache_s* tree,
     bottom_match->queue = QUEUE_AM;
     bottom_match->readahead_skip = 0;
     bottom_match->readahead_len = 0;
+    bottom_match->prefetched_unused = 0;
     // Set the page to the one the caller already allocated
     bottom_match->page = page;
     // Clear the valid lines
@@ -1904,6 +2051,7 @@ struct cache_entry_s* make_entry(struct rdcache_s* tree,
     bottom_tmp->queue = QUEUE_AIN;
     bottom_tmp->readahead_skip = 0;
     bottom_tmp->readahead_len = 0;
+    bottom_tmp->prefetched_unused = 0;
 
     bottom_tmp->next = NULL;
     bottom_tmp->prev = NULL;
@@ -1987,6 +2135,8 @@ void cache_put(struct rdcache_s* cache,
       // Is this cache line available for use, based on when we
       // last ran an acquire fence?
       entry_after_acquire = ( entry->min_sequence_number >= last_acquire );
+      if( ! entry_after_acquire )
+        CACHE_DIAGS_INCR(cache, acquire_invalidations);
    
       // If the cache line contains any overlapping writes or prefetches,
       // we must wait for them to complete before we store new data.
@@ -2404,6 +2554,11 @@ void cache_get(struct rdcache_s* cache,
         // If the cache line is in Am, move it to the front of Am.
         use_entry(cache, entry);
         if( ! isprefetch ) {
+          CACHE_DIAGS_INCR(cache, get_hits);
+          if( entry->prefetched_unused ) {
+            CACHE_DIAGS_INCR(cache, readahead_used);
+            entry->prefetched_unused = 0;
+          }
       
           //printf("cache hit on page %i:%p %p ra_len %i\n", 
           //       node, (void*) ra_page, (void*) requested_start,
@@ -2443,6 +2598,9 @@ void cache_get(struct rdcache_s* cache,
       // as invalid and clear the min and max request numbers.
       // We also need to wait for pending puts using that data...
 
+      if( ! entry_after_acquire )
+        CACHE_DIAGS_INCR(cache, acquire_invalidations);
+
       // If the cache line contains any overlapping writes or prefetches,
       // we must wait for them to complete before we request new data.
       // Prefetches might not yet have filled in the data according
@@ -2455,6 +2613,11 @@ void cache_get(struct rdcache_s* cache,
 
     // Otherwise -- start a get !
 
+    if( ! isprefetch ) {
+      if( entry ) CACHE_DIAGS_INCR(cache, get_partial_hits);
+      else CACHE_DIAGS_INCR(cache, get_misses);
+    }
+
     if( ! page ) {
       // get a page from the free list.
       page = allocate_page(cache);
@@ -2504,6 +2667,8 @@ void cache_get(struct rdcache_s* cache,
       // This will increment next request number so cache events are recorded.
       sn = pending_push(cache, handle);
       entry->max_prefetch_sequence_number = seqn_max(entry->max_prefetch_sequence_number, sn);
+      entry->prefetched_unused = 1;
+      CACHE_DIAGS_INCR(cache, readahead_issued);
     }
 
     // Set the minimum sequence number
@@ -2585,6 +2750,119 @@ void cache_get(struct rdcache_s* cache,
 #endif
 }
 
+static inline
+struct stride_entry_s* stride_entry_for(struct rdcache_s* cache,
+                                        int ln, int32_t fn)
+{
+  uint32_t h = ((uint32_t) ln) * 0x9e3779b1u ^ ((uint32_t) fn) * 0x85ebca6bu;
+  return &cache->stride_table[(h >> 16) & (STRIDE_TABLE_SIZE-1)];
+}
+
+// Can we prefetch len bytes at prefetch_raddr without risking a GET
+// from unmapped memory? As with readahead, if we don't have segment
+// information we only allow prefetches on the same system page as the
+// GET that was actually requested.
+static
+int stride_prefetch_ok(c_nodeid_t node,
+                       raddr_t prefetch_raddr, size_t len,
+                       raddr_t request_raddr, size_t request_size)
+{
+  uintptr_t page_mask;
+
+  if( chpl_comm_addr_gettable(node, (void*)prefetch_raddr, len) )
+    return 1;
+
+  page_mask = sys_page_size() - 1;
+  return round_down_to_mask(request_raddr, page_mask) <=
+           round_down_to_mask(prefetch_raddr, page_mask) &&
+         round_down_to_mask(prefetch_raddr+len-1, page_mask) <=
+           round_down_to_mask(request_raddr+request_size-1, page_mask);
+}
+
+// Record a GET of raddr..raddr+size-1 from call site (ln, fn)
+// in the stride prediction table, and if the call site has been
+// reading at a constant stride, prefetch the next elements.
+static
+void cache_get_trigger_stride(struct rdcache_s* cache,
+                              c_nodeid_t node, raddr_t raddr, size_t size,
+                              cache_seqn_t last_acquire,
+                              int32_t commID, int ln, int32_t fn)
+{
+  struct stride_entry_s* e;
+  intptr_t stride;
+  intptr_t ahead;
+  raddr_t prefetch_raddr;
+  int k;
+
+  if( STRIDE_PREFETCH_DISTANCE == 0 || size == 0 ) return;
+
+  e = stride_entry_for(cache, ln, fn);
+
+  if( e->last_raddr == 0 || e->ln != ln || e->fn != fn || e->node != node ) {
+    // Start tracking a new stream (replacing any other call site)
+    e->fn = fn;
+    e->ln = ln;
+    e->node = node;
+    e->last_raddr = raddr;
+    e->stride = 0;
+    e->confidence = 0;
+    e->prefetched_raddr = 0;
+    return;
+  }
+
+  stride = (intptr_t) (raddr - e->last_raddr);
+
+  // Reading the same address again (e.g. another field of the same
+  // element) tells us nothing about the stream.
+  if( stride == 0 ) return;
+
+  e->last_raddr = raddr;
+
+  if( stride != e->stride ) {
+    e->stride = stride;
+    e->confidence = 0;
+    e->prefetched_raddr = 0;
+    return;
+  }
+
+  if( e->confidence < STRIDE_PREFETCH_CONFIDENCE ) e->confidence++;
+  if( e->confidence < STRIDE_PREFETCH_CONFIDENCE ) return;
+
+  // Strides within a cache line hit in the cache already, and the
+  // sequential readahead handles streams of adjacent lines.
+  if( stride > -CACHELINE_SIZE && stride < CACHELINE_SIZE ) return;
+
+  if( is_congested(cache) ) return;
+
+  // Continue from the last address prefetched, if it is still ahead
+  // of this access (and not too far ahead).
+  k = 1;
+  if( e->prefetched_raddr != 0 ) {
+    ahead = (intptr_t) (e->prefetched_raddr - raddr) / stride;
+    if( ahead >= 1 && ahead <= STRIDE_PREFETCH_DISTANCE )
+      k = ahead + 1;
+  }
+
+  for( ; k <= STRIDE_PREFETCH_DISTANCE; k++ ) {
+    prefetch_raddr = raddr + k * stride;
+
+    // Stop if the stream would wrap around the address space.
+    if( (stride > 0) ? (prefetch_raddr < raddr) : (prefetch_raddr > raddr) )
+      break;
+    if( prefetch_raddr == 0 ) break;
+    if( ! stride_prefetch_ok(node, prefetch_raddr, size, raddr, size) )
+      break;
+
+    INFO_PRINT(("%i stride prefetch %i:%p stride %i\n",
+                (int) chpl_nodeID, (int) node, (void*) prefetch_raddr,
+                (int) stride));
+
+    cache_get(cache, NULL /* prefetch */, node, prefetch_raddr, size,
+              last_acquire, 0, commID, ln, fn);
+    e->prefetched_raddr = prefetch_raddr;
+  }
+}
+
 
 #if 0
 static
@@ -2673,6 +2951,15 @@ static struct rdcache_s* cache_create(void);
 CHPL_TLS_DECL(struct rdcache_s*,cache_remote_data);
 static pthread_key_t pthread_cache_info_key; // stores struct rdcache_s*
 
+// All of the caches on this locale are kept in a list so that their
+// diagnostic counters can be summed. The lock protects the list and
+// retired_cache_diags, which holds the counts from caches whose
+// pthreads have exited. It is only taken when a cache is created or
+// destroyed and when the counters are retrieved or reset.
+static pthread_mutex_t cache_list_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct rdcache_s* cache_list_head = NULL;
+static chpl_cacheDiagnostics retired_cache_diags;
+
 static
 struct rdcache_s* tls_cache_remote_data(void) {
   struct rdcache_s *cache = CHPL_TLS_GET(cache_remote_data);
@@ -2680,33 +2967,166 @@ struct rdcache_s* tls_cache_remote_data(void) {
     cache = cache_create();
     CHPL_TLS_SET(cache_remote_data, cache);
     pthread_setspecific(pthread_cache_info_key, cache);
+
+    pthread_mutex_lock(&cache_list_lock);
+    cache->next_cache = cache_list_head;
+    cache_list_head = cache;
+    pthread_mutex_unlock(&cache_list_lock);
   }
   return cache;
 }
 
+// Returns the calling task's cache data, for use with the given cache.
+// If the task last did an acquire in some other pthread's cache (that
+// is, it has migrated since), its last acquire sequence number is
+// meaningless here, so do a fresh acquire in this cache.  A task that
+// hasn't used any cache yet keeps the last acquire it started with, so
+// it can use what its pthread has already cached.
 static
-chpl_cache_taskPrvData_t* task_private_cache_data(void)
+chpl_cache_taskPrvData_t* task_private_cache_data(struct rdcache_s* cache)
 {
   chpl_task_prvData_t* task_local = chpl_task_getPrvData();
-  return &task_local->comm_data.cache_data;
+  chpl_cache_taskPrvData_t* cache_data = &task_local->comm_data.cache_data;
+  if( cache_data->cache != cache ) {
+    if( cache_data->cache != NULL ) {
+      cache_data->last_acquire = cache->next_request_number;
+      cache->next_request_number++;
+    }
+    cache_data->cache = cache;
+  }
+  return cache_data;
 }
 
 static
 void destroy_pthread_local_cache(void* arg)
 {
   struct rdcache_s* s = (struct rdcache_s*) arg;
+  struct rdcache_s** cur;
+
+  // Remove it from the list of caches, keeping its counts.
+  pthread_mutex_lock(&cache_list_lock);
+  for( cur = &cache_list_head; *cur; cur = &(*cur)->next_cache ) {
+    if( *cur == s ) {
+      *cur = s->next_cache;
+      break;
+    }
+  }
+  chpl_cache_diags_add(&retired_cache_diags, &s->diags);
+  pthread_mutex_unlock(&cache_list_lock);
+
   cache_destroy(s);
 }
 
+// Returns log2 of a size given by environment variable ev, or dflt_bits
+// if it is not set. Sizes that are not a power of 2 are rounded down to
+// one, and the result is clamped to [min_bits, max_bits].
+static
+int cache_env_size_bits(const char* ev, int dflt_bits,
+                        int min_bits, int max_bits)
+{
+  size_t size;
+  int bits;
+  char msg[200];
+
+  size = chpl_env_rt_get_size(ev, ((size_t) 1) << dflt_bits);
+  if( size == 0 ) {
+    bits = dflt_bits;
+  } else {
+    bits = 63 - (int) chpl_bitops_clz_64(size);
+    if( (((size_t) 1) << bits) != size ) {
+      snprintf(msg, sizeof(msg),
+               "CHPL_RT_%s should be a power of 2; using %zu",
+               ev, ((size_t) 1) << bits);
+      chpl_warning(msg, 0, 0);
+    }
+  }
+
+  if( bits < min_bits || bits > max_bits ) {
+    bits = (bits < min_bits) ? min_bits : max_bits;
+    snprintf(msg, sizeof(msg),
+             "CHPL_RT_%s must be between %zu and %zu; using %zu",
+             ev, ((size_t) 1) << min_bits, ((size_t) 1) << max_bits,
+             ((size_t) 1) << bits);
+    chpl_warning(msg, 0, 0);
+  }
+
+  return bits;
+}
+
+// Choose the cache page size, line size, readahead window and
+// cache size. This must run before any cache is created.
+static
+void chpl_cache_init_geometry(void)
+{
+  int max_page_bits = MAX_CACHEPAGE_BITS;
+  int sys_page_bits;
+  int other_bits;
+  int64_t pages_per_prefetch;
+  int64_t stride_distance;
+
+  // A cache page must not span system pages, since readahead
+  // uses system pages to decide what is safe to get.
+  sys_page_bits = 63 - (int) chpl_bitops_clz_64(sys_page_size());
+  if( sys_page_bits < max_page_bits ) max_page_bits = sys_page_bits;
+
+  cache_geometry.page_bits = cache_env_size_bits("CACHE_PAGE_SIZE",
+                                                 DEFAULT_CACHEPAGE_BITS,
+                                                 MIN_CACHEPAGE_BITS,
+                                                 max_page_bits);
+  cache_geometry.line_bits = cache_env_size_bits("CACHE_LINE_SIZE",
+                                                 DEFAULT_CACHELINE_BITS,
+                                                 MIN_CACHELINE_BITS,
+                                                 cache_geometry.page_bits);
+
+  pages_per_prefetch = chpl_env_rt_get_int("CACHE_READAHEAD_PAGES",
+                                           DEFAULT_PAGES_PER_PREFETCH);
+  if( pages_per_prefetch < 1 ) {
+    chpl_warning("CHPL_RT_CACHE_READAHEAD_PAGES must be > 0", 0, 0);
+    pages_per_prefetch = DEFAULT_PAGES_PER_PREFETCH;
+  }
+  // Keep a readahead window from taking over the cache.
+  if( pages_per_prefetch > MIN_CACHE_PAGES / 4 )
+    pages_per_prefetch = MIN_CACHE_PAGES / 4;
+  cache_geometry.pages_per_prefetch = (int) pages_per_prefetch;
+
+  stride_distance = chpl_env_rt_get_int("CACHE_STRIDE_PREFETCH_DISTANCE",
+                                        DEFAULT_STRIDE_PREFETCH_DISTANCE);
+  if( stride_distance < 0 ) {
+    chpl_warning("CHPL_RT_CACHE_STRIDE_PREFETCH_DISTANCE must be >= 0", 0, 0);
+    stride_distance = DEFAULT_STRIDE_PREFETCH_DISTANCE;
+  }
+  if( stride_distance > MAX_STRIDE_PREFETCH_DISTANCE )
+    stride_distance = MAX_STRIDE_PREFETCH_DISTANCE;
+  cache_geometry.stride_prefetch_distance = (int) stride_distance;
+
+  cache_geometry.data_size = chpl_env_rt_get_size("CACHE_SIZE", 0);
+  if( cache_geometry.data_size > MAX_CACHE_DATA_SIZE )
+    cache_geometry.data_size = MAX_CACHE_DATA_SIZE;
+
+  // Divide the bits not used by the page offset or the hash indices
+  // between the two halves of the pointer tree.
+  other_bits = 64 - TOP_BITS - BOTTOM_BITS - cache_geometry.page_bits;
+  cache_geometry.low_other_bits = other_bits / 2;
+  cache_geometry.high_other_bits = other_bits - other_bits / 2;
+
+  INFO_PRINT(("%i cache geometry page %i line %i readahead pages %i "
+              "size %zu\n", (int) chpl_nodeID,
+              CACHEPAGE_SIZE, CACHELINE_SIZE, MAX_PAGES_PER_PREFETCH,
+              cache_geometry.data_size));
+}
+
 static
 void chpl_cache_do_init(void)
 {
   static int inited = 0;
   if( ! inited ) {
   
+    chpl_cache_init_geometry();
+
     // Quick configuration check...
-    assert(OTHER_BITS+TOP_BITS+OTHER_BITS+BOTTOM_BITS+CACHEPAGE_BITS == 64);
-    assert(HALF_BITS + HALF_BITS + CACHEPAGE_BITS == 64);
+    assert(HIGH_OTHER_BITS+TOP_BITS+LOW_OTHER_BITS+BOTTOM_BITS+CACHEPAGE_BITS == 64);
+    assert(HIGH_HALF_BITS + LOW_HALF_BITS + CACHEPAGE_BITS == 64);
+    assert(HIGH_HALF_BITS <= 32);
 
     // Otherwise, we will need some thread-local storage.
     // We create two versions: cache_remote_data stores
@@ -2758,7 +3178,7 @@ void chpl_cache_fence(int acquire, int release, int ln, int32_t fn)
   if( acquire == 0 && release == 0 ) return;
   if( chpl_cache_enabled() ) {
     struct rdcache_s* cache = tls_cache_remote_data();
-    chpl_cache_taskPrvData_t* task_local = task_private_cache_data();
+    chpl_cache_taskPrvData_t* task_local = task_private_cache_data(cache);
 
     INFO_PRINT(("%i fence acquire %i release %i %s:%i\n", chpl_nodeID, acquire, release, fn, ln));
 
@@ -2793,7 +3213,7 @@ void chpl_cache_comm_put(void* addr, c_nodeid_t node, void* raddr,
 {
   //printf("put len %d node %d raddr %p\n", (int) len * elemSize, node, raddr);
   struct rdcache_s* cache = tls_cache_remote_data();
-  chpl_cache_taskPrvData_t* task_local = task_private_cache_data();
+  chpl_cache_taskPrvData_t* task_local = task_private_cache_data(cache);
   TRACE_PRINT(("%d: task %d in chpl_cache_comm_put %s:%d put %d bytes to %d:%p "
                "from %p\n",
                chpl_nodeID, (int)chpl_task_getId(), chpl_lookupFilename(fn), ln,
@@ -2819,7 +3239,7 @@ void chpl_cache_comm_get(void *addr, c_nodeid_t node, void* raddr,
 {
   //printf("get len %d node %d raddr %p\n", (int) len * elemSize, node, raddr);
   struct rdcache_s* cache = tls_cache_remote_data();
-  chpl_cache_taskPrvData_t* task_local = task_private_cache_data();
+  chpl_cache_taskPrvData_t* task_local = task_private_cache_data(cache);
   TRACE_PRINT(("%d: task %d in chpl_cache_comm_get %s:%d get %d bytes from "
                "%d:%p to %p\n",
                chpl_nodeID, (int)chpl_task_getId(), chpl_lookupFilename(fn), ln,
@@ -2836,6 +3256,10 @@ void chpl_cache_comm_get(void *addr, c_nodeid_t node, void* raddr,
   cache_get(cache, addr, node, (raddr_t)raddr, size, task_local->last_acquire,
             0, commID, ln, fn);
 
+  if( ENABLE_STRIDE_PREFETCH )
+    cache_get_trigger_stride(cache, node, (raddr_t)raddr, size,
+                             task_local->last_acquire, commID, ln, fn);
+
   return;
 }
 
@@ -2844,7 +3268,7 @@ void chpl_cache_comm_prefetch(c_nodeid_t node, void* raddr,
                               int ln, int32_t fn)
 {
   struct rdcache_s* cache = tls_cache_remote_data();
-  chpl_cache_taskPrvData_t* task_local = task_private_cache_data();
+  chpl_cache_taskPrvData_t* task_local = task_private_cache_data(cache);
   TRACE_PRINT(("%d: in chpl_cache_comm_prefetch\n", chpl_nodeID));
   if (chpl_verbose_comm)
     printf("%d: %s:%d: remote prefetch from %d\n", chpl_nodeID,
@@ -2901,11 +3325,39 @@ void chpl_cache_comm_put_strd(void *addr, void *dststr, c_nodeid_t node,
 #endif
 }
 
+// Reset the cache diagnostic counters of all the caches on this locale.
+// Counts from a pthread that is using its cache at the same time may be
+// lost, so this should be done while comm diagnostics are stopped.
+void chpl_resetCacheDiagnosticsHere(void)
+{
+  struct rdcache_s* cur;
+
+  pthread_mutex_lock(&cache_list_lock);
+  chpl_cache_diags_reset(&retired_cache_diags);
+  for( cur = cache_list_head; cur; cur = cur->next_cache ) {
+    chpl_cache_diags_reset(&cur->diags);
+  }
+  pthread_mutex_unlock(&cache_list_lock);
+}
+
+// Sum the cache diagnostic counters of all the caches on this locale.
+void chpl_getCacheDiagnosticsHere(chpl_cacheDiagnostics *cd)
+{
+  struct rdcache_s* cur;
+
+  pthread_mutex_lock(&cache_list_lock);
+  *cd = retired_cache_diags;
+  for( cur = cache_list_head; cur; cur = cur->next_cache ) {
+    chpl_cache_diags_add(cd, &cur->diags);
+  }
+  pthread_mutex_unlock(&cache_list_lock);
+}
+
 // This is for debugging.
 void chpl_cache_print(void)
 {
   struct rdcache_s* cache = tls_cache_remote_data();
-  chpl_cache_taskPrvData_t* task_local = task_private_cache_data();
+  chpl_cache_taskPrvData_t* task_local = task_private_cache_data(cache);
   printf("%d: cache dump last acquire %i\n", chpl_nodeID, (int) task_local->last_acquire);
   rdcache_print(cache);
 }
@@ -0,0 +1,315 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// Communication diagnostics by source location.
+//
+// When CHPL_RT_COMM_DIAGS_BY_SITE is set, we install comm callbacks
+// that count every GET, PUT and executeOn initiated on this locale,
+// keyed by the source line and file it came from.  Each pthread counts
+// into its own hash table so that counting needs no synchronization.
+// At exit the tables are merged and the busiest sites are printed.
+//
+// executeOn events don't carry a source location, so they're all
+// counted against a single "unknown" site.
+//
+
+#include "chplrt.h"
+
+#include "chpl-comm.h"
+#include "chpl-comm-callbacks.h"
+#include "chpl-comm-diags.h"
+#include "chpl-env.h"
+#include "chpl-linefile-support.h"
+#include "chpl-mem-sys.h"
+#include "chpl-thread-local-storage.h"
+#include "error.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+typedef struct {
+  chpl_bool used;
+  int       lineno;
+  int32_t   filename;
+  uint64_t  gets;
+  uint64_t  get_bytes;
+  uint64_t  puts;
+  uint64_t  put_bytes;
+  uint64_t  ons;
+} site_counts_t;
+
+typedef struct site_table_s {
+  struct site_table_s* next;      // list of all tables, for the report
+  size_t               size;      // number of slots, a power of 2
+  size_t               num_used;
+  site_counts_t*       slots;
+} site_table_t;
+
+#define SITE_TABLE_INITIAL_SIZE 256
+
+static chpl_bool sites_enabled = false;
+static int sites_top;                     // how many sites to report
+
+static pthread_mutex_t tables_lock = PTHREAD_MUTEX_INITIALIZER;
+static site_table_t* tables;              // every pthread's table
+
+static CHPL_TLS_DECL(site_table_t*, my_table);
+
+
+static inline
+size_t site_hash(int lineno, int32_t filename) {
+  uint64_t key = ((uint64_t) (uint32_t) filename << 32) | (uint32_t) lineno;
+  return (size_t) ((key * UINT64_C(0x9E3779B97F4A7C15)) >> 32);
+}
+
+static
+site_counts_t* site_find(site_table_t* t, int lineno, int32_t filename) {
+  size_t mask = t->size - 1;
+  size_t i;
+
+  for (i = site_hash(lineno, filename) & mask; ; i = (i + 1) & mask) {
+    site_counts_t* s = &t->slots[i];
+    if (!s->used) {
+      s->used = true;
+      s->lineno = lineno;
+      s->filename = filename;
+      t->num_used++;
+      return s;
+    }
+    if (s->lineno == lineno && s->filename == filename)
+      return s;
+  }
+}
+
+static
+void site_table_grow(site_table_t* t) {
+  site_counts_t* old_slots = t->slots;
+  size_t old_size = t->size;
+  size_t i;
+
+  t->size *= 2;
+  t->num_used = 0;
+  t->slots = sys_calloc(t->size, sizeof(t->slots[0]));
+  if (t->slots == NULL)
+    chpl_internal_error("cannot grow comm diagnostics site table");
+
+  for (i = 0; i < old_size; i++) {
+    if (old_slots[i].used) {
+      site_counts_t* s = site_find(t, old_slots[i].lineno,
+                                   old_slots[i].filename);
+      *s = old_slots[i];
+    }
+  }
+
+  sys_free(old_slots);
+}
+
+static
+site_table_t* site_table_new(size_t size) {
+  site_table_t* t;
+
+  if ((t = sys_calloc(1, sizeof(*t))) == NULL
+      || (t->slots = sys_calloc(size, sizeof(t->slots[0]))) == NULL)
+    chpl_internal_error("cannot allocate comm diagnostics site table");
+  t->size = size;
+  return t;
+}
+
+//
+// Get the counters for the given site in this pthread's table.
+//
+static inline
+site_counts_t* my_site(int lineno, int32_t filename) {
+  site_table_t* t = CHPL_TLS_GET(my_table);
+
+  if (t == NULL) {
+    t = site_table_new(SITE_TABLE_INITIAL_SIZE);
+    pthread_mutex_lock(&tables_lock);
+    t->next = tables;
+    tables = t;
+    pthread_mutex_unlock(&tables_lock);
+    CHPL_TLS_SET(my_table, t);
+  }
+
+  // Keep the load factor at or below 1/2.
+  if (2 * (t->num_used + 1) > t->size)
+    site_table_grow(t);
+
+  return site_find(t, lineno, filename);
+}
+
+
+static
+void count_comm(const chpl_comm_cb_info_t* info) {
+  const struct chpl_comm_info_comm* c = &info->iu.comm;
+  site_counts_t* s = my_site(c->lineno, c->filename);
+
+  switch (info->event_kind) {
+  case chpl_comm_cb_event_kind_get:
+  case chpl_comm_cb_event_kind_get_nb:
+    s->gets++;
+    s->get_bytes += c->size;
+    break;
+  default:
+    s->puts++;
+    s->put_bytes += c->size;
+    break;
+  }
+}
+
+static
+void count_comm_strd(const chpl_comm_cb_info_t* info) {
+  const struct chpl_comm_info_comm_strd* c = &info->iu.comm_strd;
+  site_counts_t* s = my_site(c->lineno, c->filename);
+  uint64_t bytes = c->elemSize;
+  int32_t i;
+
+  for (i = 0; i <= c->stridelevels; i++)
+    bytes *= c->count[i];
+
+  if (info->event_kind == chpl_comm_cb_event_kind_get_strd) {
+    s->gets++;
+    s->get_bytes += bytes;
+  } else {
+    s->puts++;
+    s->put_bytes += bytes;
+  }
+}
+
+static
+void count_executeOn(const chpl_comm_cb_info_t* info) {
+  my_site(0, 0)->ons++;
+}
+
+
+void chpl_comm_diags_sites_init(void) {
+  if (!chpl_env_rt_get_bool("COMM_DIAGS_BY_SITE", false))
+    return;
+
+  sites_top = (int) chpl_env_rt_get_int("COMM_DIAGS_BY_SITE_TOP", 20);
+
+  CHPL_TLS_INIT(my_table);
+
+  if (chpl_comm_install_callback(chpl_comm_cb_event_kind_get, count_comm)
+      || chpl_comm_install_callback(chpl_comm_cb_event_kind_get_nb,
+                                    count_comm)
+      || chpl_comm_install_callback(chpl_comm_cb_event_kind_put, count_comm)
+      || chpl_comm_install_callback(chpl_comm_cb_event_kind_put_nb,
+                                    count_comm)
+      || chpl_comm_install_callback(chpl_comm_cb_event_kind_get_strd,
+                                    count_comm_strd)
+      || chpl_comm_install_callback(chpl_comm_cb_event_kind_put_strd,
+                                    count_comm_strd)
+      || chpl_comm_install_callback(chpl_comm_cb_event_kind_executeOn,
+                                    count_executeOn)
+      || chpl_comm_install_callback(chpl_comm_cb_event_kind_executeOn_nb,
+                                    count_executeOn)
+      || chpl_comm_install_callback(chpl_comm_cb_event_kind_executeOn_fast,
+                                    count_executeOn)) {
+    chpl_warning("cannot install callbacks for CHPL_RT_COMM_DIAGS_BY_SITE",
+                 0, 0);
+    return;
+  }
+
+  sites_enabled = true;
+}
+
+
+static inline
+uint64_t site_total(const site_counts_t* s) {
+  return s->gets + s->puts + s->ons;
+}
+
+static
+int site_cmp(const void* a, const void* b) {
+  uint64_t ta = site_total((const site_counts_t*) a);
+  uint64_t tb = site_total((const site_counts_t*) b);
+  return (ta < tb) ? 1 : (ta > tb) ? -1 : 0;
+}
+
+//
+// Merge the per-pthread tables and print the sites with the most
+// communication.  This is called once all communication is done.
+//
+void chpl_comm_diags_sites_report(void) {
+  site_table_t* merged;
+  site_table_t* t;
+  site_counts_t* sites;
+  size_t num_sites;
+  size_t i;
+  char buf[200];
+
+  if (!sites_enabled)
+    return;
+
+  merged = site_table_new(SITE_TABLE_INITIAL_SIZE);
+  for (t = tables; t != NULL; t = t->next) {
+    for (i = 0; i < t->size; i++) {
+      const site_counts_t* s = &t->slots[i];
+      site_counts_t* m;
+      if (!s->used)
+        continue;
+      if (2 * (merged->num_used + 1) > merged->size)
+        site_table_grow(merged);
+      m = site_find(merged, s->lineno, s->filename);
+      m->gets      += s->gets;
+      m->get_bytes += s->get_bytes;
+      m->puts      += s->puts;
+      m->put_bytes += s->put_bytes;
+      m->ons       += s->ons;
+    }
+  }
+
+  // Compact the used slots to the front, then sort by total count.
+  sites = merged->slots;
+  for (i = num_sites = 0; i < merged->size; i++) {
+    if (sites[i].used)
+      sites[num_sites++] = sites[i];
+  }
+  qsort(sites, num_sites, sizeof(sites[0]), site_cmp);
+
+  if (sites_top >= 0 && num_sites > (size_t) sites_top)
+    num_sites = (size_t) sites_top;
+
+  printf("%d: comm diagnostics by site (top %zu of %zu):\n",
+         chpl_nodeID, num_sites, merged->num_used);
+  printf("%d: %12s %14s %12s %14s %12s  %s\n", chpl_nodeID,
+         "gets", "get bytes", "puts", "put bytes", "ons", "site");
+  for (i = 0; i < num_sites; i++) {
+    const site_counts_t* s = &sites[i];
+    if (s->lineno == 0 && s->filename == 0)
+      snprintf(buf, sizeof(buf), "<unknown>");
+    else
+      snprintf(buf, sizeof(buf), "%s:%d",
+               chpl_lookupFilename(s->filename), s->lineno);
+    printf("%d: %12" PRIu64 " %14" PRIu64 " %12" PRIu64 " %14" PRIu64
+           " %12" PRIu64 "  %s\n",
+           chpl_nodeID, s->gets, s->get_bytes, s->puts, s->put_bytes,
+           s->ons, buf);
+  }
+  fflush(stdout);
+
+  sys_free(merged->slots);
+  sys_free(merged);
+}
@@ -78,6 +78,16 @@ void chpl_gen_stopCommDiagnosticsHere(void) {
   chpl_stopCommDiagnosticsHere();
 }
 
+#ifndef HAS_CHPL_CACHE_FNS
+// Without a remote data cache there is nothing to count.
+// (chpl-cache.c provides these when there is one.)
+void chpl_resetCacheDiagnosticsHere(void) { }
+
+void chpl_getCacheDiagnosticsHere(chpl_cacheDiagnostics *cd) {
+  memset(cd, 0, sizeof(chpl_cacheDiagnostics));
+}
+#endif
+
 
 static int maxHeapSize_set;
 static pthread_once_t maxHeapSize_once = PTHREAD_ONCE_INIT;
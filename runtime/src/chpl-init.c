@@ -24,6 +24,7 @@
 #include "chplcast.h"
 #include "chplcgfns.h"
 #include "chpl-comm.h"
+#include "chpl-comm-diags.h"
 #include "chplexit.h"
 #include "chplio.h"
 #include "chpl-init.h"
@@ -198,6 +199,7 @@ void chpl_rt_init(int argc, char* argv[]) {
   //
   chpl_comm_post_task_init();
   chpl_comm_rollcall();
+  chpl_comm_diags_sites_init();
 
   //
   // Make sure the runtime is fully set up on all locales before we start
@@ -19,71 +19,146 @@
 
 #include "chplrt.h"
 #include "chpl-privatization.h"
+#include "chpl-comm.h"
 #include "chpl-mem.h"
-#include "chpl-tasks.h"
+#include "error.h"
 
-static int64_t chpl_capPrivateObjects = 0;
-static chpl_sync_aux_t privatizationSync;
+//
+// Each block holds CHPL_PRIVATIZATION_BLOCK_SIZE object slots followed
+// by the same number of free-list links, one per slot.
+//
+atomic_uintptr_t chpl_privateObjects[CHPL_PRIVATIZATION_MAX_BLOCKS];
 
-void** chpl_privateObjects = NULL;
+#define MAX_PIDS ((int64_t) CHPL_PRIVATIZATION_MAX_BLOCKS \
+                  * CHPL_PRIVATIZATION_BLOCK_SIZE)
+
+// Next never-used pid.
+static atomic_int_least64_t nextPid;
+
+// Head of the list of recycled pids, as (tag << 32) | (pid + 1), with
+// 0 in the low half meaning the list is empty.  The tag changes on
+// every update so that a pop can't be fooled by a pid that was popped
+// and pushed again in between (ABA).
+static atomic_uint_least64_t freePids;
+
+#define FREE_PID_MASK ((uint64_t) 0xffffffff)
 
 void chpl_privatization_init(void) {
-    chpl_sync_initAux(&privatizationSync);
+  for (int i = 0; i < CHPL_PRIVATIZATION_MAX_BLOCKS; i++)
+    atomic_init_uintptr_t(&chpl_privateObjects[i], (uintptr_t) NULL);
+  atomic_init_int_least64_t(&nextPid, 0);
+  atomic_init_uint_least64_t(&freePids, 0);
+}
+
+// Return the block holding the given pid, allocating it if this is the
+// first pid in it.  Several tasks may race to allocate the same block;
+// the first one to install its block wins and the others free theirs.
+static void** getBlock(int64_t pid) {
+  atomic_uintptr_t* blockp;
+  uintptr_t block;
+
+  if (pid < 0 || pid >= MAX_PIDS)
+    chpl_internal_error("too many privatized objects");
+
+  blockp = &chpl_privateObjects[pid >> CHPL_PRIVATIZATION_BLOCK_BITS];
+  block = atomic_load_uintptr_t(blockp);
+  if (block == (uintptr_t) NULL) {
+    uintptr_t newBlock = (uintptr_t)
+      chpl_mem_allocManyZero(CHPL_PRIVATIZATION_BLOCK_SIZE,
+                             sizeof(void*) + sizeof(atomic_int_least64_t),
+                             CHPL_RT_MD_COMM_PRV_OBJ_ARRAY, 0, 0);
+    if (atomic_compare_exchange_strong_uintptr_t(blockp, (uintptr_t) NULL,
+                                                 newBlock)) {
+      block = newBlock;
+    } else {
+      chpl_mem_free((void*) newBlock, 0, 0);
+      block = atomic_load_uintptr_t(blockp);
+    }
+  }
+  return (void**) block;
+}
+
+static inline atomic_int_least64_t* freeLink(void** block, int64_t pid) {
+  atomic_int_least64_t* links =
+    (atomic_int_least64_t*) (block + CHPL_PRIVATIZATION_BLOCK_SIZE);
+  return &links[pid & (CHPL_PRIVATIZATION_BLOCK_SIZE - 1)];
 }
 
-static inline int64_t max(int64_t a, int64_t b) {
-  return a > b ? a : b;
+// Pids are only handed out on locale 0 (see _newPrivatizedClass() in
+// ChapelArray.chpl), so only its free list is ever popped.  Reuse a
+// recycled pid if there is one, otherwise take a new one.
+int64_t chpl_newPrivatizedPid(void) {
+  uint64_t head = atomic_load_uint_least64_t(&freePids);
+
+  while ((head & FREE_PID_MASK) != 0) {
+    int64_t pid = (int64_t) (head & FREE_PID_MASK) - 1;
+    uint64_t next = (uint64_t)
+      atomic_load_int_least64_t(freeLink(getBlock(pid), pid));
+    uint64_t newHead = (((head >> 32) + 1) << 32) | next;
+    if (atomic_compare_exchange_strong_uint_least64_t(&freePids, head,
+                                                      newHead))
+      return pid;
+    head = atomic_load_uint_least64_t(&freePids);
+  }
+
+  return atomic_fetch_add_int_least64_t(&nextPid, 1);
 }
 
 // Note that this function can be called in parallel and more notably it can be
 // called with non-monotonic pid's. e.g. this may be called with pid 27, and
-// then pid 2, so it has to ensure that the privatized array has at least pid+1
-// elements. Be __very__ careful if you have to update it.
+// then pid 2, so it has to make sure the block for pid exists.  Existing
+// blocks never move, so nothing here needs a lock.
 void chpl_newPrivatizedClass(void* v, int64_t pid) {
-  chpl_sync_lock(&privatizationSync);
-
-  // initialize array to a default size
-  if (chpl_privateObjects == NULL) {
-    chpl_capPrivateObjects = 2*max(pid, 4);
-    chpl_privateObjects =
-        chpl_mem_allocManyZero(chpl_capPrivateObjects, sizeof(void *),
-                           CHPL_RT_MD_COMM_PRV_OBJ_ARRAY, 0, 0);
-  } else {
-    // if we're out of space, double (or more) the array size
-    if (pid >= chpl_capPrivateObjects) {
-      void** tmp;
-      int64_t oldCap;
-
-      oldCap = chpl_capPrivateObjects;
-      chpl_capPrivateObjects = 2*max(pid, oldCap);
-
-      tmp = chpl_mem_allocManyZero(chpl_capPrivateObjects, sizeof(void *),
-                                   CHPL_RT_MD_COMM_PRV_OBJ_ARRAY, 0, 0);
-      chpl_memcpy((void*)tmp, (void*)chpl_privateObjects, (oldCap)*sizeof(void*));
-      chpl_privateObjects = tmp;
-      // purposely leak old copies of chpl_privateObject to avoid the need to
-      // lock chpl_getPrivatizedClass; TODO: fix with lock free data structure
-    }
-  }
-  chpl_privateObjects[pid] = v;
+  void** block = getBlock(pid);
+  block[pid & (CHPL_PRIVATIZATION_BLOCK_SIZE - 1)] = v;
 
-  chpl_sync_unlock(&privatizationSync);
+  // Keep chpl_numPrivatizedClasses() covering every pid in use here,
+  // including ones allocated on another locale.
+  {
+    int64_t next = atomic_load_int_least64_t(&nextPid);
+    while (next <= pid &&
+           !atomic_compare_exchange_strong_int_least64_t(&nextPid, next,
+                                                         pid + 1))
+      next = atomic_load_int_least64_t(&nextPid);
+  }
 }
 
-void chpl_clearPrivatizedClass(int64_t i) {
-  chpl_sync_lock(&privatizationSync);
-  chpl_privateObjects[i] = NULL;
-  chpl_sync_unlock(&privatizationSync);
+// Clear the slot and, on locale 0, put its pid on the free list.
+// _freePrivatizedClass() clears locale 0 last, so by the time a pid can
+// be reused from there it is clear everywhere.  Clearing a slot that is
+// already clear doesn't free the pid again.
+void chpl_clearPrivatizedClass(int64_t pid) {
+  void** block = getBlock(pid);
+  void** slot = &block[pid & (CHPL_PRIVATIZATION_BLOCK_SIZE - 1)];
+  uint64_t head;
+  uint64_t newHead;
+
+  if (*slot == NULL)
+    return;
+  *slot = NULL;
+
+  if (chpl_nodeID != 0)
+    return;
+
+  do {
+    head = atomic_load_uint_least64_t(&freePids);
+    atomic_store_int_least64_t(freeLink(block, pid),
+                               (int64_t) (head & FREE_PID_MASK));
+    newHead = (((head >> 32) + 1) << 32) | (uint64_t) (pid + 1);
+  } while (!atomic_compare_exchange_strong_uint_least64_t(&freePids, head,
+                                                          newHead));
 }
 
 // Used to check for leaks of privatized classes
 int64_t chpl_numPrivatizedClasses(void) {
   int64_t ret = 0;
-  chpl_sync_lock(&privatizationSync);
-  for (int64_t i = 0; i < chpl_capPrivateObjects; i++) {
-    if (chpl_privateObjects[i])
+  int64_t numPids = atomic_load_int_least64_t(&nextPid);
+  for (int64_t i = 0; i < numPids; i++) {
+    void** block = (void**)
+      atomic_load_uintptr_t(
+          &chpl_privateObjects[i >> CHPL_PRIVATIZATION_BLOCK_BITS]);
+    if (block && block[i & (CHPL_PRIVATIZATION_BLOCK_SIZE - 1)])
       ret++;
   }
-  chpl_sync_unlock(&privatizationSync);
   return ret;
 }
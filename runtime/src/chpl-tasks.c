@@ -22,6 +22,7 @@
 // tasks/<tasklayer>/tasks-<tasklayer>.c
 //
 #include "chplrt.h"
+#include "chpl-cache.h"
 #include "chpl-comm.h"
 #include "chpl-tasks.h"
 #include "chpl-topo.h"
@@ -207,3 +208,11 @@ size_t chpl_task_getDefaultCallStackSize(void)
 
   return deflt;
 }
+
+
+void chpl_task_beforeMigration(void)
+{
+#ifdef HAS_CHPL_CACHE_FNS
+  chpl_cache_release(0, 0);
+#endif
+}
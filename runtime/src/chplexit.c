@@ -21,11 +21,13 @@
 
 #include "chpl_rt_utils_static.h"
 #include "chpl-comm.h"
+#include "chpl-comm-diags.h"
 #include "chplexit.h"
 #include "chpl-mem.h"
 #include "chplmemtrack.h"
 #include "chpl-topo.h"
 #include "gdb.h"
+#include "qbuffer.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -38,7 +40,9 @@ static void chpl_exit_common(int status, int all) {
   }
   chpl_comm_pre_task_exit(all);
   if (all) {
+    chpl_comm_diags_sites_report();
     chpl_task_exit();
+    qbytes_iobuf_pool_exit();
     chpl_reportMemInfo();
   }
   chpl_comm_exit(all, status);
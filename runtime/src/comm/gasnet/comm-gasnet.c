@@ -27,6 +27,7 @@
 #include "chpl-comm-diags.h"
 #include "chpl-comm-callbacks.h"
 #include "chpl-comm-callbacks-internal.h"
+#include "chpl-env.h"
 #include "chpl-mem.h"
 #include "chplsys.h"
 #include "chpl-tasks.h"
@@ -50,6 +51,7 @@
 #include <string.h>
 #include <assert.h>
 #include <time.h>
+#include <pthread.h>
 
 static chpl_atomic_commDiagnostics comm_diagnostics;
 static int chpl_comm_no_debug_private = 0;
@@ -242,6 +244,7 @@ typedef enum {
   FORK_NB_LARGE,        // non-blocking fork with a huge argument
   FORK_FAST,            // run the function in the handler (use with care)
   FORK_FAST_SMALL,      // run the function in the handler (use with care)
+  FORK_NB_AGG,          // batch of non-blocking small forks
 
   SIGNAL,               // ack to a done_t via gasnet_AMReplyShortM()
   SIGNAL_LONG,          // ack to a done_t via gasnet_AMReplyLongM()
@@ -421,10 +424,8 @@ static void AM_fork_nb(gasnet_token_t  token,
                            f->task_bundle.requestedSubloc, chpl_nullTaskID);
 }
 
-static void AM_fork_nb_small(gasnet_token_t  token,
-                             void           *buf,
-                             size_t          nbytes) {
-  small_fork_hdr_t *f = buf;
+static inline
+void start_nb_small_fork(small_fork_hdr_t *f, size_t nbytes) {
   small_fork_task_t task;
   chpl_comm_on_bundle_t *bptr = &task.bundle;
   size_t size;
@@ -437,6 +438,157 @@ static void AM_fork_nb_small(gasnet_token_t  token,
                            f->subloc, chpl_nullTaskID);
 }
 
+static void AM_fork_nb_small(gasnet_token_t  token,
+                             void           *buf,
+                             size_t          nbytes) {
+  start_nb_small_fork((small_fork_hdr_t*) buf, nbytes);
+}
+
+
+//
+// Aggregation of non-blocking small forks.
+//
+// When enabled (CHPL_RT_COMM_GASNET_AGGREGATE_FORKS), instead of
+// sending each small execute_on_nb as its own AM we append it to a
+// per-destination buffer and send the whole buffer as one FORK_NB_AGG
+// AM.  A buffer is sent when the next fork wouldn't fit in it, when
+// the polling task finds that its oldest fork has waited longer than
+// the timeout, before a blocking fork to the same node, and at
+// barriers and exit.  Each record in a batch is a uint64_t giving the
+// size of the small fork message that follows, padded to 8 bytes.
+//
+typedef struct {
+  pthread_mutex_t lock;
+  volatile size_t used;        // bytes of buf in use
+  gasnett_tick_t  first;       // when the oldest fork in buf was added
+  char*           buf;         // allocated on first use
+} fork_agg_buf_t;
+
+static chpl_bool fork_agg_enabled = false;
+static size_t fork_agg_max_size;        // never send more than this at once
+static uint64_t fork_agg_timeout_ns;    // max time a fork waits in buf
+static fork_agg_buf_t* fork_agg_bufs;   // one per node
+
+static inline
+size_t fork_agg_rec_size(size_t nbytes) {
+  return (sizeof(uint64_t) + nbytes + 7) & ~(size_t) 7;
+}
+
+static void AM_fork_nb_agg(gasnet_token_t token, void* buf, size_t nbytes) {
+  char* p = (char*) buf;
+  char* end = p + nbytes;
+
+  while (p < end) {
+    size_t msg_size = (size_t) *(uint64_t*) p;
+    start_nb_small_fork((small_fork_hdr_t*) (p + sizeof(uint64_t)), msg_size);
+    p += fork_agg_rec_size(msg_size);
+  }
+}
+
+static void fork_agg_init(void) {
+  size_t max_medium = gasnet_AMMaxMedium();
+  int i;
+
+  if (!chpl_env_rt_get_bool("COMM_GASNET_AGGREGATE_FORKS", false))
+    return;
+
+  fork_agg_max_size = chpl_env_rt_get_size("COMM_GASNET_AGGREGATE_FORKS_SIZE",
+                                           max_medium);
+  if (fork_agg_max_size > max_medium)
+    fork_agg_max_size = max_medium;
+  if (fork_agg_max_size < fork_agg_rec_size(sizeof(special_fork_t)))
+    fork_agg_max_size = fork_agg_rec_size(sizeof(special_fork_t));
+  fork_agg_timeout_ns =
+    1000 * (uint64_t) chpl_env_rt_get_int("COMM_GASNET_AGGREGATE_FORKS_TIMEOUT",
+                                          50);
+
+  fork_agg_bufs = chpl_mem_allocManyZero(chpl_numNodes, sizeof(fork_agg_bufs[0]),
+                                         CHPL_RT_MD_COMM_PER_LOC_INFO, 0, 0);
+  for (i = 0; i < chpl_numNodes; i++)
+    pthread_mutex_init(&fork_agg_bufs[i].lock, NULL);
+
+  fork_agg_enabled = true;
+}
+
+// Send whatever is buffered for the given node.  Caller holds the lock.
+static inline
+void fork_agg_send_locked(c_nodeid_t node, fork_agg_buf_t* b) {
+  if (b->used > 0) {
+    GASNET_Safe(gasnet_AMRequestMedium0(node, FORK_NB_AGG, b->buf, b->used));
+    b->used = 0;
+  }
+}
+
+static void fork_agg_add(c_nodeid_t node, small_fork_hdr_t* f, size_t nbytes) {
+  fork_agg_buf_t* b = &fork_agg_bufs[node];
+  size_t rec_size = fork_agg_rec_size(nbytes);
+
+  pthread_mutex_lock(&b->lock);
+
+  if (b->buf == NULL)
+    b->buf = chpl_mem_alloc(fork_agg_max_size, CHPL_RT_MD_COMM_XMIT_RCV_BUF,
+                            0, 0);
+  else if (b->used + rec_size > fork_agg_max_size)
+    fork_agg_send_locked(node, b);
+
+  if (b->used == 0)
+    b->first = gasnett_ticks_now();
+  *(uint64_t*) (b->buf + b->used) = nbytes;
+  memcpy(b->buf + b->used + sizeof(uint64_t), f, nbytes);
+  b->used += rec_size;
+
+  pthread_mutex_unlock(&b->lock);
+}
+
+static void fork_agg_flush_node(c_nodeid_t node) {
+  fork_agg_buf_t* b;
+
+  if (!fork_agg_enabled)
+    return;
+
+  b = &fork_agg_bufs[node];
+  if (b->used == 0)
+    return;
+
+  pthread_mutex_lock(&b->lock);
+  fork_agg_send_locked(node, b);
+  pthread_mutex_unlock(&b->lock);
+}
+
+static void fork_agg_flush_all(void) {
+  c_nodeid_t node;
+
+  if (!fork_agg_enabled)
+    return;
+
+  for (node = 0; node < chpl_numNodes; node++)
+    fork_agg_flush_node(node);
+}
+
+//
+// Called by the polling task: send any buffers whose oldest fork has
+// waited too long.  We don't wait for a lock some task is holding,
+// since that task is about to send or add to the buffer anyway.
+//
+static void fork_agg_flush_stale(void) {
+  gasnett_tick_t now;
+  c_nodeid_t node;
+
+  if (!fork_agg_enabled)
+    return;
+
+  now = gasnett_ticks_now();
+  for (node = 0; node < chpl_numNodes; node++) {
+    fork_agg_buf_t* b = &fork_agg_bufs[node];
+    if (b->used > 0
+        && gasnett_ticks_to_ns(now - b->first) >= fork_agg_timeout_ns
+        && pthread_mutex_trylock(&b->lock) == 0) {
+      fork_agg_send_locked(node, b);
+      pthread_mutex_unlock(&b->lock);
+    }
+  }
+}
+
 
 static void fork_nb_large_wrapper(large_fork_task_t* f) {
   large_fork_t *lg = &f->large;
@@ -597,6 +749,7 @@ static gasnet_handlerentry_t ftable[] = {
   {FORK_NB_LARGE, AM_fork_nb_large},
   {FORK_FAST,     AM_fork_fast},
   {FORK_FAST_SMALL, AM_fork_fast_small},
+  {FORK_NB_AGG,   AM_fork_nb_agg},
   {SIGNAL,        AM_signal},
   {SIGNAL_LONG,   AM_signal_long},
   {PRIV_BCAST,    AM_priv_bcast},
@@ -701,6 +854,91 @@ int chpl_comm_try_nb_some(chpl_comm_nb_handle_t* h, size_t nhandles)
   return gasnet_try_syncnb_some((gasnet_handle_t*) h, nhandles) == GASNET_OK;
 }
 
+//
+// Vectored GETs and PUTs.  We start all the in-segment transfers inside
+// one GASNet NBI access region, which gives us a single handle for the
+// lot.  Any that aren't in the segment are done first, one at a time,
+// since those may block and yield, and another task on this thread
+// could then try to start an access region of its own.
+//
+static inline
+chpl_comm_nb_handle_t xferv_nb(chpl_bool isGet, size_t n, void** addrs,
+                               c_nodeid_t* nodes, void** raddrs,
+                               size_t* sizes, int32_t typeIndex,
+                               int32_t commID, int ln, int32_t fn)
+{
+  chpl_comm_cb_event_kind_t etype = isGet ? chpl_comm_cb_event_kind_get_nb
+                                          : chpl_comm_cb_event_kind_put_nb;
+  size_t i;
+  size_t num_in_segment = 0;
+
+  for (i = 0; i < n; i++) {
+#ifdef GASNET_SEGMENT_EVERYTHING
+    num_in_segment++;
+#else
+    if (chpl_comm_addr_gettable(nodes[i], raddrs[i], sizes[i]))
+      num_in_segment++;
+    else if (isGet)
+      chpl_comm_get(addrs[i], nodes[i], raddrs[i], sizes[i],
+                    typeIndex, commID, ln, fn);
+    else
+      chpl_comm_put(addrs[i], nodes[i], raddrs[i], sizes[i],
+                    typeIndex, commID, ln, fn);
+#endif
+  }
+
+  if (num_in_segment == 0)
+    return NULL;
+
+  gasnet_begin_nbi_accessregion();
+
+  for (i = 0; i < n; i++) {
+#ifndef GASNET_SEGMENT_EVERYTHING
+    if (!chpl_comm_addr_gettable(nodes[i], raddrs[i], sizes[i]))
+      continue;
+#endif
+
+    // Communication callbacks
+    if (chpl_comm_have_callbacks(etype)) {
+      chpl_comm_cb_info_t cb_data =
+        {etype, chpl_nodeID, nodes[i],
+         .iu.comm={addrs[i], raddrs[i], sizes[i], typeIndex, commID, ln, fn}};
+      chpl_comm_do_callbacks (&cb_data);
+    }
+
+    if (isGet)
+      gasnet_get_nbi_bulk(addrs[i], nodes[i], raddrs[i], sizes[i]);
+    else
+      gasnet_put_nbi_bulk(nodes[i], raddrs[i], addrs[i], sizes[i]);
+  }
+
+  if (chpl_comm_diagnostics && !chpl_comm_no_debug_private) {
+    (void) atomic_fetch_add_uint_least64_t(isGet ? &comm_diagnostics.get_nb
+                                                 : &comm_diagnostics.put_nb,
+                                           num_in_segment);
+  }
+
+  return (chpl_comm_nb_handle_t) gasnet_end_nbi_accessregion();
+}
+
+chpl_comm_nb_handle_t chpl_comm_getv(size_t n, void** addrs,
+                                     c_nodeid_t* nodes, void** raddrs,
+                                     size_t* sizes, int32_t typeIndex,
+                                     int32_t commID, int ln, int32_t fn)
+{
+  return xferv_nb(true, n, addrs, nodes, raddrs, sizes,
+                  typeIndex, commID, ln, fn);
+}
+
+chpl_comm_nb_handle_t chpl_comm_putv(size_t n, void** addrs,
+                                     c_nodeid_t* nodes, void** raddrs,
+                                     size_t* sizes, int32_t typeIndex,
+                                     int32_t commID, int ln, int32_t fn)
+{
+  return xferv_nb(false, n, addrs, nodes, raddrs, sizes,
+                  typeIndex, commID, ln, fn);
+}
+
 int chpl_comm_addr_gettable(c_nodeid_t node, void* start, size_t len)
 {
 #ifdef GASNET_SEGMENT_EVERYTHING
@@ -747,6 +985,7 @@ static void polling(void* x) {
   pollingRunning = 1;
   while (!pollingQuit) {
     (void) gasnet_AMPoll();
+    fork_agg_flush_stale();
     chpl_task_yield();
   }
   pollingRunning = 0;
@@ -908,6 +1147,8 @@ void chpl_comm_post_task_init(void) {
     sched_yield();
   }
 
+  fork_agg_init();
+
   // Initialize the caching layer, if it is active.
   chpl_cache_init();
 }
@@ -1008,6 +1249,9 @@ void chpl_comm_barrier(const char *msg) {
   chpl_msg(2, "%d: enter barrier for '%s'\n", chpl_nodeID, msg);
 #endif
 
+  // A barrier is a fence for aggregated forks.
+  fork_agg_flush_all();
+
   //
   // We don't want to just do a gasnet_barrier_wait() here, because
   // GASNet will put us to work polling, and we already have a polling
@@ -1463,9 +1707,13 @@ void  execute_on_common(c_nodeid_t node, c_sublocid_t subloc,
 
   chpl_task_ChapelData_t state = *chpl_task_getChapelData();
 
-  if (blocking)
+  if (blocking) {
     init_done_obj(&done, 1);
 
+    // Keep forks to the same node in the order they were made.
+    fork_agg_flush_node(node);
+  }
+
   // Don't consider it fast if it's large, because the
   // handler has to GET the bundle.
   fast = fast && ! large;
@@ -1514,8 +1762,11 @@ void  execute_on_common(c_nodeid_t node, c_sublocid_t subloc,
       // Copy in the payload
       memcpy(f + 1, arg + 1, payload_size);
     
-      // Send the AM
-      GASNET_Safe(gasnet_AMRequestMedium0(node, op, f, small_msg_size));
+      // Send the AM, or add it to the batch for this node
+      if (op == FORK_NB_SMALL && fork_agg_enabled)
+        fork_agg_add(node, f, small_msg_size);
+      else
+        GASNET_Safe(gasnet_AMRequestMedium0(node, op, f, small_msg_size));
     } else {
       // Setup a small message pointing to arg
       // so the other side can GET from it
@@ -95,6 +95,32 @@ int chpl_comm_try_nb_some(chpl_comm_nb_handle_t* h, size_t nhandles)
   return 0;
 }
 
+chpl_comm_nb_handle_t chpl_comm_getv(size_t n, void** addrs,
+                                     c_nodeid_t* nodes, void** raddrs,
+                                     size_t* sizes, int32_t typeIndex,
+                                     int32_t commID, int ln, int32_t fn)
+{
+  size_t i;
+  for( i = 0; i < n; i++ ) {
+    assert(nodes[i] == 0);
+    chpl_memcpy(addrs[i], raddrs[i], sizes[i]);
+  }
+  return NULL;
+}
+
+chpl_comm_nb_handle_t chpl_comm_putv(size_t n, void** addrs,
+                                     c_nodeid_t* nodes, void** raddrs,
+                                     size_t* sizes, int32_t typeIndex,
+                                     int32_t commID, int ln, int32_t fn)
+{
+  size_t i;
+  for( i = 0; i < n; i++ ) {
+    assert(nodes[i] == 0);
+    chpl_memcpy(raddrs[i], addrs[i], sizes[i]);
+  }
+  return NULL;
+}
+
 int chpl_comm_addr_gettable(c_nodeid_t node, void* start, size_t len)
 {
   return 0;
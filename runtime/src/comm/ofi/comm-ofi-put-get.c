@@ -138,6 +138,39 @@ int chpl_comm_try_nb_some(chpl_comm_nb_handle_t* h, size_t nhandles)
   return 0;
 }
 
+//
+// Vectored GETs and PUTs.  For now these just do the individual
+// transfers, which complete before they return, so the handle is
+// always NULL.
+//
+chpl_comm_nb_handle_t chpl_comm_getv(size_t n, void** addrs,
+                                     c_nodeid_t* nodes, void** raddrs,
+                                     size_t* sizes, int32_t typeIndex,
+                                     int32_t commID, int ln, int32_t fn) {
+  size_t i;
+  for (i = 0; i < n; i++) {
+    chpl_comm_nb_handle_t handle;
+    handle = chpl_comm_get_nb(addrs[i], nodes[i], raddrs[i], sizes[i],
+                              typeIndex, commID, ln, fn);
+    chpl_comm_wait_nb_some(&handle, 1);
+  }
+  return NULL;
+}
+
+chpl_comm_nb_handle_t chpl_comm_putv(size_t n, void** addrs,
+                                     c_nodeid_t* nodes, void** raddrs,
+                                     size_t* sizes, int32_t typeIndex,
+                                     int32_t commID, int ln, int32_t fn) {
+  size_t i;
+  for (i = 0; i < n; i++) {
+    chpl_comm_nb_handle_t handle;
+    handle = chpl_comm_put_nb(addrs[i], nodes[i], raddrs[i], sizes[i],
+                              typeIndex, commID, ln, fn);
+    chpl_comm_wait_nb_some(&handle, 1);
+  }
+  return NULL;
+}
+
 void  chpl_comm_put(void* addr, c_nodeid_t node, void* raddr,
                     size_t size, int32_t typeIndex, int32_t commID,
                     int ln, int32_t fn) {
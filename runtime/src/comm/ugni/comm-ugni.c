@@ -5933,6 +5933,57 @@ void  chpl_comm_get_strd(void* dstaddr_arg, size_t* dststrides,
 }
 
 
+//
+// Vectored GETs and PUTs.  Each transfer gets its own NB descriptor,
+// so we can't hand back one handle for all of them.  Instead we keep
+// up to strd_maxHandles of them in flight, as the strided routines do,
+// and wait for all of them before returning.
+//
+static inline
+void xferv_helper(chpl_comm_nb_handle_t (*xferFn)(void*, int32_t, void*,
+                                                  size_t,
+                                                  int32_t, int32_t,
+                                                  int, int32_t),
+                  size_t n, void** addrs, c_nodeid_t* nodes, void** raddrs,
+                  size_t* sizes,
+                  int32_t typeIndex, int32_t commID, int ln, int32_t fn)
+{
+  chpl_comm_nb_handle_t handles[strd_maxHandles];
+  size_t currHandles = 0;
+
+  for (size_t i = 0; i < n; i++) {
+    strd_nb_helper(xferFn, addrs[i], nodes[i], raddrs[i], sizes[i],
+                   handles, &currHandles,
+                   typeIndex, commID, ln, fn);
+  }
+
+  if (currHandles > 0)
+    (void) chpl_comm_wait_nb_some(handles, currHandles);
+}
+
+
+chpl_comm_nb_handle_t chpl_comm_getv(size_t n, void** addrs,
+                                     c_nodeid_t* nodes, void** raddrs,
+                                     size_t* sizes, int32_t typeIndex,
+                                     int32_t commID, int ln, int32_t fn)
+{
+  xferv_helper(chpl_comm_get_nb, n, addrs, nodes, raddrs, sizes,
+               typeIndex, commID, ln, fn);
+  return NULL;
+}
+
+
+chpl_comm_nb_handle_t chpl_comm_putv(size_t n, void** addrs,
+                                     c_nodeid_t* nodes, void** raddrs,
+                                     size_t* sizes, int32_t typeIndex,
+                                     int32_t commID, int ln, int32_t fn)
+{
+  xferv_helper(chpl_comm_put_nb, n, addrs, nodes, raddrs, sizes,
+               typeIndex, commID, ln, fn);
+  return NULL;
+}
+
+
 //
 // Non-blocking get interface
 //
@@ -18,12 +18,104 @@
  */
 
 #include "chplrt.h"
+#include "chpl-cache.h"
 #include "chpl-comm.h"
 #include "chpl-comm-compiler-macros.h"
 #include "chpl-linefile-support.h"
 
 #include "bulkget.h"
 
+//
+// The data transfers here are split into chunks of at most this many
+// bytes.  All the chunks of a transfer are started before we wait for
+// any of them, so several can be in flight at once, and a large buffer
+// made of many iobufs costs one round trip instead of one per iobuf.
+//
+#define BULK_CHUNK_SIZE (1024*1024)
+
+//
+// Copy between the local pieces in iov and the contiguous remote region
+// starting at raddr on node, in either direction.
+//
+static
+qioerr bulk_xfer(chpl_bool isGet, c_nodeid_t node, void* raddr,
+                 const struct iovec* iov, size_t iovcnt)
+{
+  void** addrs = NULL;
+  void** raddrs = NULL;
+  size_t* sizes = NULL;
+  c_nodeid_t* nodes = NULL;
+  MAYBE_STACK_SPACE(void*, addrs_onstack);
+  MAYBE_STACK_SPACE(void*, raddrs_onstack);
+  MAYBE_STACK_SPACE(size_t, sizes_onstack);
+  MAYBE_STACK_SPACE(c_nodeid_t, nodes_onstack);
+  chpl_comm_nb_handle_t handle;
+  size_t nchunks = 0;
+  size_t i, j, off;
+  char* rptr = (char*) raddr;
+  qioerr err = 0;
+
+  if( node == chpl_nodeID ) {
+    for( i = 0; i < iovcnt; i++ ) {
+      if( isGet ) chpl_memcpy(iov[i].iov_base, rptr, iov[i].iov_len);
+      else chpl_memcpy(rptr, iov[i].iov_base, iov[i].iov_len);
+      rptr += iov[i].iov_len;
+    }
+    return 0;
+  }
+
+  for( i = 0; i < iovcnt; i++ )
+    nchunks += (iov[i].iov_len + BULK_CHUNK_SIZE - 1) / BULK_CHUNK_SIZE;
+  if( nchunks == 0 ) return 0;
+
+  MAYBE_STACK_ALLOC(void*, nchunks, addrs, addrs_onstack);
+  MAYBE_STACK_ALLOC(void*, nchunks, raddrs, raddrs_onstack);
+  MAYBE_STACK_ALLOC(size_t, nchunks, sizes, sizes_onstack);
+  MAYBE_STACK_ALLOC(c_nodeid_t, nchunks, nodes, nodes_onstack);
+  if( ! addrs || ! raddrs || ! sizes || ! nodes ) {
+    err = QIO_ENOMEM;
+    goto done;
+  }
+
+  j = 0;
+  for( i = 0; i < iovcnt; i++ ) {
+    for( off = 0; off < iov[i].iov_len; off += BULK_CHUNK_SIZE ) {
+      addrs[j] = PTR_ADDBYTES(iov[i].iov_base, off);
+      raddrs[j] = rptr + off;
+      sizes[j] = iov[i].iov_len - off;
+      if( sizes[j] > BULK_CHUNK_SIZE ) sizes[j] = BULK_CHUNK_SIZE;
+      nodes[j] = node;
+      j++;
+    }
+    rptr += iov[i].iov_len;
+  }
+
+#ifdef HAS_CHPL_CACHE_FNS
+  // These transfers bypass the remote data cache, so finish any of this
+  // task's cached PUTs and drop its cached GETs first.
+  if( chpl_cache_enabled() )
+    chpl_cache_fence(1, 1, -1, CHPL_FILE_IDX_INTERNAL);
+#endif
+
+  if( isGet )
+    handle = chpl_comm_getv(nchunks, addrs, nodes, raddrs, sizes,
+                            CHPL_TYPE_uint8_t, CHPL_COMM_UNKNOWN_ID,
+                            -1, CHPL_FILE_IDX_INTERNAL);
+  else
+    handle = chpl_comm_putv(nchunks, addrs, nodes, raddrs, sizes,
+                            CHPL_TYPE_uint8_t, CHPL_COMM_UNKNOWN_ID,
+                            -1, CHPL_FILE_IDX_INTERNAL);
+  if( handle != NULL )
+    chpl_comm_wait_nb_some(&handle, 1);
+
+done:
+  MAYBE_STACK_FREE(addrs, addrs_onstack);
+  MAYBE_STACK_FREE(raddrs, raddrs_onstack);
+  MAYBE_STACK_FREE(sizes, sizes_onstack);
+  MAYBE_STACK_FREE(nodes, nodes_onstack);
+  return err;
+}
+
 // The initial ref count in the return qbytes buffer is 1.
 // The caller is responsible for calling qbytes_release on it when done.
 qbytes_t* bulk_get_bytes(int64_t src_locale, qbytes_t* src_addr)
@@ -32,6 +124,7 @@ qbytes_t* bulk_get_bytes(int64_t src_locale, qbytes_t* src_addr)
   qbytes_t* ret;
   int64_t src_len;
   void* src_data;
+  struct iovec iov;
   qioerr err;
 
   // Zero-initialize tmp.
@@ -44,18 +137,27 @@ qbytes_t* bulk_get_bytes(int64_t src_locale, qbytes_t* src_addr)
   src_len = tmp.len;
   src_data = tmp.data;
 
-  // The initial ref count is 1.
-  err = qbytes_create_calloc(&ret, src_len);
-  if( err ) return NULL;
-
-  // TODO -- note -- technically, this should be gasnet_get_bulk,
-  // since we don't want to require src/dst to have a particular alignment.
+  if( ! src_data || src_len == 0 ) {
+    // The initial ref count is 1.
+    err = qbytes_create_calloc(&ret, src_len);
+    if( err ) return NULL;
+    return ret;
+  }
 
-  // Next, get the data itself.
-  if( src_data ) {
-    chpl_gen_comm_get(ret->data, src_locale, src_data,
-                      sizeof(uint8_t) * src_len, CHPL_TYPE_uint8_t,
-                      CHPL_COMM_UNKNOWN_ID, -1, CHPL_FILE_IDX_INTERNAL);
+  // Allocate the qbytes like qbytes_create_calloc does, but don't
+  // bother zeroing data that we're about to overwrite.
+  ret = (qbytes_t*) qio_malloc(sizeof(qbytes_t) + src_len);
+  if( ! ret ) return NULL;
+  // The initial ref count is 1.
+  _qbytes_init_generic(ret, ret + 1, src_len, qbytes_free_null);
+
+  // Next, get the data itself, directly into the new bytes.
+  iov.iov_base = ret->data;
+  iov.iov_len = src_len;
+  err = bulk_xfer(true, src_locale, src_data, &iov, 1);
+  if( err ) {
+    qbytes_release(ret);
+    return NULL;
   }
 
   // Great! All done.
@@ -69,41 +171,23 @@ qioerr bulk_put_buffer(int64_t dst_locale, void* dst_addr, int64_t dst_len,
   ssize_t num_parts = qbuffer_iter_num_parts(start, end);
   struct iovec* iov = NULL;
   size_t iovcnt;
-  size_t i,j;
   MAYBE_STACK_SPACE(struct iovec, iov_onstack);
   qioerr err;
  
   if( num_bytes < 0 || num_parts < 0 || start.offset < buf->offset_start || end.offset > buf->offset_end )  QIO_RETURN_CONSTANT_ERROR(EINVAL, "range outside of buffer");
 
+  if( num_bytes > dst_len ) QIO_RETURN_CONSTANT_ERROR(EMSGSIZE, "no space in buffer");
+
   MAYBE_STACK_ALLOC(struct iovec, num_parts, iov, iov_onstack);
   if( ! iov ) return QIO_ENOMEM;
 
   err = qbuffer_to_iov(buf, start, end, num_parts, iov, NULL, &iovcnt);
   if( err ) goto error;
 
-  j = 0;
-  for( i = 0; i < iovcnt; i++ ) {
-    if( j + iov[i].iov_len > dst_len ) goto error_nospace;
-    //chpl_memcpy(PTR_ADDBYTES(ptr, j), iov[i].iov_base, iov[i].iov_len);
-
-    // TODO -- note -- technically, this should be gasnet_put_bulk,
-    // since we don't want to require src/dst to have a particular alignment.
-    chpl_gen_comm_put( iov[i].iov_base,
-                       dst_locale,
-                       PTR_ADDBYTES(dst_addr, j),
-                       sizeof(uint8_t)*iov[i].iov_len, CHPL_TYPE_uint8_t,
-                       CHPL_COMM_UNKNOWN_ID, -1, CHPL_FILE_IDX_INTERNAL);
-
-    j += iov[i].iov_len;
-  }
+  // Put all of the parts at once, rather than waiting for each in turn.
+  err = bulk_xfer(false, dst_locale, dst_addr, iov, iovcnt);
 
-  MAYBE_STACK_FREE(iov, iov_onstack);
-  return 0;
-
-error_nospace:
-  QIO_RETURN_CONSTANT_ERROR(EMSGSIZE, "no space in buffer");
 error:
   MAYBE_STACK_FREE(iov, iov_onstack);
   return err;
 }
-
@@ -28,6 +28,7 @@
 #include "error.h"
 
 #include "sys.h"
+#include "chpl-thread-local-storage.h"
 
 #include <limits.h>
 #include <sys/mman.h>
@@ -40,6 +41,9 @@
 // but we can't know page size at compile time
 size_t qbytes_iobuf_size = 64*1024;
 
+ssize_t qbytes_iobuf_pool_high = 64; // keep up to 64 iobufs (4M) per thread
+ssize_t qbytes_iobuf_pool_low = 16;
+
 // prototypes.
 
 void qbytes_free_iobuf(qbytes_t* b);
@@ -85,11 +89,146 @@ void qbytes_free_qio_free(qbytes_t* b) {
   qio_free(b->data);
   _qbytes_free_qbytes(b);
 }
+
+//
+// Per-thread iobuf pools.  Each pthread keeps the iobufs released on it
+// in a free list linked through the first word of each buffer, so that
+// tasks which create and destroy many short-lived channels don't go to
+// the memory layer for every buffer.  A thread only touches its own
+// pool, except for the statistics and at exit, so the pools need no
+// locking.  All of a pool's buffers are qbytes_iobuf_size long; if that
+// changes, the pool is emptied before it is refilled.
+//
+typedef struct qbytes_iobuf_pool_s {
+  struct qbytes_iobuf_pool_s* next;  // list of all pools
+  void* free_list;
+  ssize_t count;
+  size_t size;
+  qbytes_iobuf_pool_stats_t stats;
+} qbytes_iobuf_pool_t;
+
+static pthread_once_t iobuf_pool_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t iobuf_pools_lock = PTHREAD_MUTEX_INITIALIZER;
+static qbytes_iobuf_pool_t* iobuf_pools;
+static int iobuf_pools_exited;
+static CHPL_TLS_DECL(qbytes_iobuf_pool_t*, iobuf_pool_mine);
+
+static
+void iobuf_pool_init(void)
+{
+  CHPL_TLS_INIT(iobuf_pool_mine);
+}
+
+// Returns this pthread's pool, creating it if need be, or NULL
+// if iobufs aren't being pooled.
+static
+qbytes_iobuf_pool_t* iobuf_pool_get(void)
+{
+  qbytes_iobuf_pool_t* p;
+
+  if( qbytes_iobuf_pool_high <= 0 || iobuf_pools_exited ) return NULL;
+
+  pthread_once(&iobuf_pool_once, iobuf_pool_init);
+
+  p = (qbytes_iobuf_pool_t*) CHPL_TLS_GET(iobuf_pool_mine);
+  if( p == NULL ) {
+    p = (qbytes_iobuf_pool_t*) qio_calloc(1, sizeof(qbytes_iobuf_pool_t));
+    if( p == NULL ) return NULL;
+    pthread_mutex_lock(&iobuf_pools_lock);
+    p->next = iobuf_pools;
+    iobuf_pools = p;
+    pthread_mutex_unlock(&iobuf_pools_lock);
+    CHPL_TLS_SET(iobuf_pool_mine, p);
+  }
+  return p;
+}
+
+// Free pooled iobufs until only keep are left.
+static
+void iobuf_pool_trim(qbytes_iobuf_pool_t* p, ssize_t keep)
+{
+  if( keep < 0 ) keep = 0;
+  while( p->count > keep ) {
+    void* data = p->free_list;
+    p->free_list = *(void**) data;
+    p->count--;
+    p->stats.trimmed++;
+    qio_free(data);
+  }
+}
+
+static
+void* iobuf_alloc(void)
+{
+  qbytes_iobuf_pool_t* p = iobuf_pool_get();
+
+  if( p ) {
+    p->stats.allocs++;
+    if( p->count > 0 && p->size == qbytes_iobuf_size ) {
+      void* data = p->free_list;
+      p->free_list = *(void**) data;
+      p->count--;
+      p->stats.hits++;
+      return data;
+    }
+  }
+
+  return qio_memalign(sys_page_size(), qbytes_iobuf_size);
+}
+
 void qbytes_free_iobuf(qbytes_t* b) {
+  qbytes_iobuf_pool_t* p;
+
+  if( b->len == (int64_t) qbytes_iobuf_size && (p = iobuf_pool_get()) ) {
+    if( p->size != qbytes_iobuf_size ) {
+      iobuf_pool_trim(p, 0);
+      p->size = qbytes_iobuf_size;
+    }
+    *(void**) b->data = p->free_list;
+    p->free_list = b->data;
+    p->count++;
+    p->stats.releases++;
+    if( p->count > qbytes_iobuf_pool_high )
+      iobuf_pool_trim(p, qbytes_iobuf_pool_low);
+    _qbytes_free_qbytes(b);
+    return;
+  }
+
   // iobuf is just something to be freed with free()
   qbytes_free_qio_free(b);
 }
 
+void qbytes_iobuf_pool_stats(qbytes_iobuf_pool_stats_t* stats)
+{
+  qbytes_iobuf_pool_t* p;
+
+  memset(stats, 0, sizeof(*stats));
+
+  pthread_mutex_lock(&iobuf_pools_lock);
+  for( p = iobuf_pools; p != NULL; p = p->next ) {
+    stats->allocs += p->stats.allocs;
+    stats->hits += p->stats.hits;
+    stats->releases += p->stats.releases;
+    stats->trimmed += p->stats.trimmed;
+    stats->pooled += p->count;
+  }
+  pthread_mutex_unlock(&iobuf_pools_lock);
+}
+
+void qbytes_iobuf_pool_exit(void)
+{
+  qbytes_iobuf_pool_t* p;
+
+  pthread_mutex_lock(&iobuf_pools_lock);
+  iobuf_pools_exited = 1;
+  while( (p = iobuf_pools) != NULL ) {
+    iobuf_pools = p->next;
+    iobuf_pool_trim(p, 0);
+    qio_free(p);
+  }
+  pthread_mutex_unlock(&iobuf_pools_lock);
+}
+
 void debug_print_bytes(qbytes_t* b)
 {
   fprintf(stderr, "bytes %p: data=%p len=%lli ref_cnt=%" PRIu64 " free_function=%p flags=%i\n",
@@ -148,7 +287,7 @@ qioerr _qbytes_init_iobuf(qbytes_t* ret)
 {
   void* data = NULL;
   
-  data = qio_memalign(sys_page_size(), qbytes_iobuf_size);
+  data = iobuf_alloc();
   if( !data ) return QIO_ENOMEM;
   memset(data, 0, qbytes_iobuf_size);
 
@@ -33,6 +33,7 @@
 
 #ifndef CHPL_RT_UNIT_TEST
 #include "chplrt.h"
+#include "chpl-env.h"
 #endif
 
 #include "qio.h"
@@ -86,19 +87,123 @@
 // because operating on such files would use a lot of extra memory
 // when rounding up to 4k pages.
 ssize_t qio_too_small_for_default_mmap = 16*1024;
-ssize_t qio_mmap_chunk_iobufs = 128; // mmap 128 iobufs at a time (8M)
+// Channels using mmap start with windows of qio_mmap_min_chunk_iobufs
+// and double them, up to qio_mmap_chunk_iobufs, while reading straight
+// through the file.  See _buffered_get_mmap.
+ssize_t qio_mmap_chunk_iobufs = 128; // mmap up to 128 iobufs at a time (8M)
+ssize_t qio_mmap_min_chunk_iobufs = 4; // but start with 4 (256K)
 
 // Future - possibly set this based on ulimit?
 ssize_t qio_initial_mmap_max = 8*1024*1024;
 bool qio_allow_default_mmap = true;
 
 #ifdef _chplrt_H_
+
+// Biased locks.
+//
+// A channel is usually only ever used by the task that created it,
+// so channel locks start out biased toward the first task that takes
+// them. While the bias holds, that task just counts its holds in
+// bias_count. When another task wants the lock it sets bias_state to
+// QIO_BIAS_REVOKING, waits for bias_count to drop to 0, and turns the
+// lock into a plain re-entrant one for good.
+//
+// The owner stores bias_count and then loads bias_state; the revoker
+// stores bias_state and then loads bias_count. One of them has to see
+// the other's store. Rather than put a full fence on the owner's side,
+// which would cost about as much as the lock we are trying to avoid,
+// the revoker forces one onto every thread with membarrier(2). So we
+// only bias locks where that is available. Setting
+// CHPL_RT_QIO_BIASED_LOCKS=false turns biasing off altogether.
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/membarrier.h>)
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#if defined(__NR_membarrier)
+#define QIO_HAS_MEMBARRIER
+#endif
+#endif
+#endif
+
+#ifdef QIO_HAS_MEMBARRIER
+static pthread_once_t qio_bias_once = PTHREAD_ONCE_INIT;
+static int qio_bias_ok = 0;
+
+static void qio_bias_setup(void) {
+  if( ! chpl_env_rt_get_bool("QIO_BIASED_LOCKS", true) ) return;
+  if( syscall(__NR_membarrier,
+              MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0) == 0 )
+    qio_bias_ok = 1;
+}
+
+int qio_lock_bias_available(void) {
+  pthread_once(&qio_bias_once, qio_bias_setup);
+  return qio_bias_ok;
+}
+
+// Pairs with qio_bias_light_fence on every other thread.
+static void qio_bias_heavy_fence(void) {
+  if( syscall(__NR_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0) != 0 )
+    chpl_internal_error("membarrier failed");
+}
+
+#define qio_bias_light_fence() __atomic_signal_fence(__ATOMIC_SEQ_CST)
+
+#else
+int qio_lock_bias_available(void) {
+  return 0;
+}
+static void qio_bias_heavy_fence(void) { }
+#define qio_bias_light_fence()
+#endif
+
+// Called with x->sv held. Take the bias away from its owner, waiting
+// until the owner isn't holding the lock, and leave the lock plain.
+static void qio_bias_revoke_locked(qio_lock_t* x) {
+  if( x->bias_state == QIO_BIAS_HELD ) {
+    x->bias_state = QIO_BIAS_REVOKING;
+    qio_bias_heavy_fence();
+    while( x->bias_count != 0 ) {
+      chpl_task_yield();
+    }
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  }
+  x->bias_state = QIO_BIAS_OFF;
+}
+
 qioerr qio_lock(qio_lock_t* x) {
   // recursive mutex based on glibc pthreads implementation
   chpl_taskID_t id = chpl_task_getId();
+  int bias_state = x->bias_state;
 
   assert( ! chpl_task_idEquals(id, NULL_OWNER) );
 
+  if( bias_state != QIO_BIAS_OFF ) {
+    if( bias_state == QIO_BIAS_UNCLAIMED ) {
+      // Become the bias owner, unless someone else got there first.
+      chpl_sync_lock(&x->sv);
+      if( x->bias_state == QIO_BIAS_UNCLAIMED ) {
+        x->bias_owner = id;
+        x->bias_state = QIO_BIAS_HELD;
+      }
+      chpl_sync_unlock(&x->sv);
+    }
+
+    if( chpl_task_idEquals(x->bias_owner, id) ) {
+      if( x->bias_count > 0 ) {
+        // We already hold it, so nobody can have finished revoking.
+        ++x->bias_count;
+        return 0;
+      }
+      x->bias_count = 1;
+      qio_bias_light_fence();
+      if( x->bias_state == QIO_BIAS_HELD ) return 0;
+      // It's being revoked; let the revoker go ahead.
+      x->bias_count = 0;
+    }
+  }
+
   // check whether we already hold the mutex.
   if( chpl_task_idEquals(x->owner, id) ) {
     // just bump the counter.
@@ -109,6 +214,8 @@ qioerr qio_lock(qio_lock_t* x) {
   // we have to get the mutex.
   chpl_sync_lock(&x->sv);
 
+  if( x->bias_state != QIO_BIAS_OFF ) qio_bias_revoke_locked(x);
+
   assert( chpl_task_idEquals(x->owner, NULL_OWNER) );
   x->count = 1;
   x->owner = id;
@@ -118,6 +225,13 @@ qioerr qio_lock(qio_lock_t* x) {
 void qio_unlock(qio_lock_t* x) {
   chpl_taskID_t id = chpl_task_getId();
 
+  // Holds taken through the bias are released through it, even if
+  // the bias is being revoked meanwhile.
+  if( x->bias_count > 0 && chpl_task_idEquals(x->bias_owner, id) ) {
+    __atomic_store_n(&x->bias_count, x->bias_count - 1, __ATOMIC_RELEASE);
+    return;
+  }
+
   // recursive mutex based on glibc pthreads implementation
   if( ! chpl_task_idEquals(x->owner, id) ) {
     abort();
@@ -588,6 +702,13 @@ qio_hint_t choose_io_method(qio_file_t* file, qio_hint_t hints, qio_hint_t defau
     } else {
       // method already chosen in hints.
     }
+
+    // io_uring needs a seekable file and a kernel that has it.
+    if( method == QIO_METHOD_URING ) {
+      if( isfilestar ) method = QIO_METHOD_FREADFWRITE;
+      else if( ! (fdflags & QIO_FDFLAG_SEEKABLE) ) method = QIO_METHOD_READWRITE;
+      else if( ! qio_uring_available() ) method = QIO_METHOD_PREADPWRITE;
+    }
   }
 
   // Always use fread/fwrite with FILE*
@@ -982,6 +1103,7 @@ qioerr _qio_file_do_close(qio_file_t* f)
   qioerr newerr;
   const char* path;
   int rc;
+  int i;
 
   //printf("closing %p fd %i fp %p\n", f, f->fd, f->fp);
 
@@ -995,6 +1117,12 @@ qioerr _qio_file_do_close(qio_file_t* f)
     f->mmap = NULL;
   }
 
+  // Channels using these windows hold their own references.
+  for( i = 0; i < QIO_MMAP_WINDOWS; i++ ) {
+    qbytes_release(f->mmap_windows[i].bytes); // Does nothing if null.
+    f->mmap_windows[i].bytes = NULL;
+  }
+
   if( f->buf ) {
     qbuffer_release(f->buf);
     f->buf = NULL;
@@ -1446,7 +1574,7 @@ qioerr _qio_channel_init(qio_channel_t* ch, qio_chtype_t type)
   ch->cached_start = NULL;
   ch->cached_start_pos = 0;
 
-  return qio_lock_init(& ch->lock);
+  return qio_lock_init_biased(& ch->lock);
 }
 
 static
@@ -1493,6 +1621,8 @@ qioerr _qio_channel_init_file_internal(qio_channel_t* ch, qio_file_t* file, qio_
   qio_file_retain(file);
   ch->file = file;
 
+  ch->mmap_next_pos = -1;
+
   ch->start_pos = start;
   ch->end_pos = end;
   // update the file with start_pos.
@@ -1807,6 +1937,8 @@ qioerr qio_channel_path_offset(const int threadsafe, qio_channel_t* ch, const ch
   return err;
 }
 
+static void _mmap_windows_prune(qio_file_t* file);
+
 qioerr _qio_channel_final_flush_unlocked(qio_channel_t* ch)
 {
   qioerr err = 0;
@@ -1893,6 +2025,14 @@ qioerr _qio_channel_final_flush_unlocked(qio_channel_t* ch)
     destroy_buffer_error = qbuffer_destroy(&ch->buf);
   }
 
+  // Unmap the shared windows this channel was the last one using.
+  if( method == QIO_METHOD_MMAP && ! (ch->flags & QIO_FDFLAG_WRITEABLE) ) {
+    if( ! qio_lock(&ch->file->lock) ) {
+      _mmap_windows_prune(ch->file);
+      qio_unlock(&ch->file->lock);
+    }
+  }
+
   ch->hints |= QIO_CHTYPE_CLOSED; // set to invalid type so funcs return EINVAL
 
   // If this channel is the last owner of the file, close the file
@@ -2165,14 +2305,72 @@ qioerr _buffered_get_memory(qio_channel_t* ch, int64_t amt, int writing)
   return err;
 }
 
+// Look for a window of the file that covers [start, start+amt).
+// Call with the file's lock held.  On success, the window is moved to
+// the front of the file's list.
+static
+qbytes_t* _mmap_window_find(qio_file_t* file, int64_t start, int64_t amt,
+                            int64_t* window_start)
+{
+  qio_mmap_window_t w;
+  int i;
+
+  for( i = 0; i < QIO_MMAP_WINDOWS && file->mmap_windows[i].bytes; i++ ) {
+    w = file->mmap_windows[i];
+    if( w.start <= start && start + amt <= w.start + w.bytes->len ) {
+      memmove(&file->mmap_windows[1], &file->mmap_windows[0],
+              i * sizeof(qio_mmap_window_t));
+      file->mmap_windows[0] = w;
+      *window_start = w.start;
+      return w.bytes;
+    }
+  }
+
+  return NULL;
+}
+
+// Remember a new window, dropping the least recently used one if need
+// be.  Call with the file's lock held.
+static
+void _mmap_window_add(qio_file_t* file, qbytes_t* bytes, int64_t start)
+{
+  qbytes_release(file->mmap_windows[QIO_MMAP_WINDOWS-1].bytes);
+  memmove(&file->mmap_windows[1], &file->mmap_windows[0],
+          (QIO_MMAP_WINDOWS-1) * sizeof(qio_mmap_window_t));
+  qbytes_retain(bytes);
+  file->mmap_windows[0].bytes = bytes;
+  file->mmap_windows[0].start = start;
+}
+
+// Drop the windows that no channel is using, so that they are unmapped
+// once the last channel using them is closed instead of staying mapped
+// until they fall off the end of the list.  Call with the file's lock
+// held.  Channels only take a window with that lock held, so one that
+// only the file refers to can't be picked up while we look.
+static
+void _mmap_windows_prune(qio_file_t* file)
+{
+  int i, j;
+
+  for( i = j = 0; i < QIO_MMAP_WINDOWS && file->mmap_windows[i].bytes; i++ ) {
+    if( DO_GET_REFCNT(file->mmap_windows[i].bytes) == 1 ) {
+      qbytes_release(file->mmap_windows[i].bytes);
+    } else {
+      file->mmap_windows[j++] = file->mmap_windows[i];
+    }
+  }
+  for( ; j < i; j++ ) file->mmap_windows[j].bytes = NULL;
+}
+
 static
 qioerr _buffered_get_mmap(qio_channel_t* ch, int64_t amt_in, int writing)
 {
   qbuffer_iter_t start;
   qioerr err;
-  size_t mmap_chunk = qio_mmap_chunk_iobufs * qbytes_iobuf_size;
+  size_t mmap_chunk;
   struct stat stats;
   int prot;
+  int flags;
   void* data;
   int64_t len;
   int64_t skip;
@@ -2181,7 +2379,11 @@ qioerr _buffered_get_mmap(qio_channel_t* ch, int64_t amt_in, int writing)
   long pagesize = 0;
   int64_t pages_in;
   int64_t map_start;
+  int64_t window_start;
   int64_t amt = amt_in;
+  int sequential;
+  int shared;
+  qio_hint_t advice_hints;
 
   err = _qio_channel_needbuffer_unlocked(ch);
   if( err ) return err;
@@ -2201,6 +2403,27 @@ qioerr _buffered_get_mmap(qio_channel_t* ch, int64_t amt_in, int writing)
 
   amt += skip;
 
+  // Choose the window size from how this channel has been reading.
+  // A channel that picks up where its last window ended is streaming
+  // through the file, so double the window each time.  Otherwise it
+  // may only want a few bytes from here, so start over with a small
+  // window.  Explicit hints override this.
+  sequential = (start.offset == ch->mmap_next_pos);
+  if( ch->hints & QIO_HINT_SEQUENTIAL ) {
+    ch->mmap_window = qio_mmap_chunk_iobufs * qbytes_iobuf_size;
+  } else if( ch->hints & QIO_HINT_RANDOM ) {
+    ch->mmap_window = qio_mmap_min_chunk_iobufs * qbytes_iobuf_size;
+  } else if( sequential ) {
+    ch->mmap_window *= 2;
+    if( ch->mmap_window > qio_mmap_chunk_iobufs * (int64_t) qbytes_iobuf_size )
+      ch->mmap_window = qio_mmap_chunk_iobufs * qbytes_iobuf_size;
+  } else {
+    ch->mmap_window = qio_mmap_min_chunk_iobufs * qbytes_iobuf_size;
+  }
+  if( ch->mmap_window < (int64_t) qbytes_iobuf_size )
+    ch->mmap_window = qbytes_iobuf_size;
+  mmap_chunk = ch->mmap_window;
+
   // Round amt up to mmap_chunk size, store in len.
   // We'll map len bytes starting at map_start.
   {
@@ -2260,23 +2483,72 @@ qioerr _buffered_get_mmap(qio_channel_t* ch, int64_t amt_in, int writing)
   if( len < amt ) eof = 1;
 
   if( len > 0 ) {
-    // OK, now mmap
     prot = PROT_READ;
     if( ch->flags & QIO_FDFLAG_WRITEABLE ) prot |= PROT_WRITE;
 
-    // This check is (only) important for 32-bit systems.
-    if( len > SSIZE_MAX ) QIO_RETURN_CONSTANT_ERROR(EOVERFLOW, "overflow in mmap");
+    // Read-only windows are shared with the other channels on this
+    // file, so first see if one of them already mapped what we need.
+    // Writable ones aren't, since a writer may later truncate the file
+    // short of its window.
+    shared = (prot == PROT_READ);
+    bytes = NULL;
+    if( shared ) {
+      err = qio_lock(&ch->file->lock);
+      if( err ) return err;
+      bytes = _mmap_window_find(ch->file, map_start,
+                                (len < amt) ? len : amt, &window_start);
+      if( bytes ) qbytes_retain(bytes);
+      qio_unlock(&ch->file->lock);
+    }
 
-    err = qio_int_to_err(sys_mmap(NULL, len, prot, MAP_SHARED, ch->file->fd, map_start, &data));
-    if( err ) return err;
+    if( bytes ) {
+      // Use the window up to where we would have mapped.
+      skip = start.offset - window_start;
+      if( window_start + bytes->len < map_start + len )
+        len = window_start + bytes->len - map_start;
+    } else {
+      // This check is (only) important for 32-bit systems.
+      if( len > SSIZE_MAX ) QIO_RETURN_CONSTANT_ERROR(EOVERFLOW, "overflow in mmap");
 
-    err = qbytes_create_generic(&bytes, data, len, qbytes_free_munmap);
-    if( err ) {
-      sys_munmap(data, len);
-      return err;
+      flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+      // Fault in streaming windows up front; we'll read all of them.
+      if( sequential && ! writing ) flags |= MAP_POPULATE;
+#endif
+
+      err = qio_int_to_err(sys_mmap(NULL, len, prot, flags, ch->file->fd, map_start, &data));
+      if( err ) return err;
+
+      // Tell the OS what to expect, unless the channel's hints did.
+      advice_hints = ch->hints;
+      if( ! (advice_hints & (QIO_HINT_RANDOM | QIO_HINT_SEQUENTIAL |
+                             QIO_HINT_CACHED)) ) {
+        advice_hints |= sequential ? QIO_HINT_SEQUENTIAL : QIO_HINT_RANDOM;
+      }
+      // Advice is only a hint, so ignore any error.
+      (void) qio_madvise_for_hints(data, len, advice_hints);
+
+      err = qbytes_create_generic(&bytes, data, len, qbytes_free_munmap);
+      if( err ) {
+        sys_munmap(data, len);
+        return err;
+      }
+
+      if( shared ) {
+        err = qio_lock(&ch->file->lock);
+        if( err ) {
+          qbytes_release(bytes);
+          return err;
+        }
+        _mmap_window_add(ch->file, bytes, map_start);
+        qio_unlock(&ch->file->lock);
+      }
+      window_start = map_start;
     }
 
-    err = qbuffer_append(&ch->buf, bytes, skip, len - skip);
+    ch->mmap_next_pos = map_start + len;
+
+    err = qbuffer_append(&ch->buf, bytes, skip, map_start + len - start.offset);
     // qbuffer_append retains ch->buf, so we can release our local reference.
     // If there was an error, then we release bytes entirely.
     qbytes_release(bytes); // munmaps on error, decs ref count normally.
@@ -2299,6 +2571,7 @@ qioerr _buffered_read_atleast(qio_channel_t* ch, int64_t amt)
   ssize_t num_read;
   int64_t left = amt;
   int64_t max_amt;
+  int64_t want = amt;
   int return_eof = 0;
   qioerr err;
   qio_method_t method = (qio_method_t) (ch->hints & QIO_METHODMASK);
@@ -2318,6 +2591,16 @@ qioerr _buffered_read_atleast(qio_channel_t* ch, int64_t amt)
     return_eof = 1;
   }
 
+  // With io_uring, ask for several iobufs at once so that they can
+  // all be in flight together.
+  if( method == QIO_METHOD_URING ) {
+    int64_t readahead = qio_uring_readahead_iobufs * qbytes_iobuf_size;
+    if( amt < readahead ) {
+      amt = readahead;
+      if( amt > max_amt ) amt = max_amt;
+    }
+  }
+
   //printf("Allocating bufferspace %lli\n", (long long int) amt);
   err = _buffered_allocate_bufferspace(ch, amt, max_amt);
   if( err ) return err;
@@ -2341,6 +2624,9 @@ qioerr _buffered_read_atleast(qio_channel_t* ch, int64_t amt)
       case QIO_METHOD_PREADPWRITE:
         err = qio_preadv(ch->file, &ch->buf, read_start, read_end, read_start.offset, &num_read);
         break;
+      case QIO_METHOD_URING:
+        err = qio_uring_preadv(ch->file, &ch->buf, read_start, read_end, read_start.offset, &num_read);
+        break;
       case QIO_METHOD_FREADFWRITE:
         err = qio_freadv(ch->file->fp, &ch->buf, read_start, read_end, &num_read);
         break;
@@ -2361,6 +2647,10 @@ qioerr _buffered_read_atleast(qio_channel_t* ch, int64_t amt)
     if( err ) break;
   }
 
+  // Reaching EOF while reading ahead is not an error if we got
+  // what was asked for.
+  if( err && qio_err_to_int(err) == EEOF && amt - left >= want ) err = 0;
+
   ch->av_end = read_start.offset;
 
   if( err ) return err;
@@ -2571,6 +2861,9 @@ qioerr _qio_buffered_behind(qio_channel_t* ch, int flushall)
         case QIO_METHOD_PREADPWRITE:
           err = qio_pwritev(ch->file, &ch->buf, write_start, write_end, write_start.offset, &num_written);
           break;
+        case QIO_METHOD_URING:
+          err = qio_uring_pwritev(ch->file, &ch->buf, write_start, write_end, write_start.offset, &num_written);
+          break;
         case QIO_METHOD_FREADFWRITE:
           err = qio_fwritev(ch->file->fp, &ch->buf, write_start, write_end, &num_written);
           break;
@@ -2796,6 +3089,7 @@ qioerr _qio_unbuffered_write(qio_channel_t* ch, const void* ptr, ssize_t len_in,
         case QIO_METHOD_MMAP: // mmap uses pread/pwrite when we're 
                               // outside the mmap'd region.
         case QIO_METHOD_PREADPWRITE:
+        case QIO_METHOD_URING: // nothing to batch for one buffer
           err = qio_int_to_err(sys_pwrite(ch->file->fd, ptr, len, _right_mark_start(ch), &num_written));
           break;
         case QIO_METHOD_FREADFWRITE:
@@ -2870,7 +3164,8 @@ qioerr _qio_unbuffered_read(qio_channel_t* ch, void* ptr, ssize_t len_in, ssize_
   len = len_in;
 
   if( ch->file->mmap &&
-      (method == QIO_METHOD_PREADPWRITE || method == QIO_METHOD_MMAP) &&
+      (method == QIO_METHOD_PREADPWRITE || method == QIO_METHOD_MMAP ||
+       method == QIO_METHOD_URING) &&
       _right_mark_start(ch) + len <= ch->file->mmap->len) {
     // As long as we're using an I/O method that seeks on every read,
     // copy the data out of the mmap.
@@ -2886,6 +3181,7 @@ qioerr _qio_unbuffered_read(qio_channel_t* ch, void* ptr, ssize_t len_in, ssize_
           break;
         case QIO_METHOD_MMAP:
         case QIO_METHOD_PREADPWRITE:
+        case QIO_METHOD_URING: // nothing to batch for one buffer
           err = qio_int_to_err(sys_pread(ch->file->fd, ptr, len, _right_mark_start(ch), &num_read));
           break;
         case QIO_METHOD_FREADFWRITE:
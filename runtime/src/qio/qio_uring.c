@@ -0,0 +1,479 @@
+/*
+ * Copyright 2004-2018 Cray Inc.
+ * Other additional copyright holders may be indicated within.
+ *
+ * The entirety of this work is licensed under the Apache License,
+ * Version 2.0 (the "License"); you may not use this file except
+ * in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* QIO_METHOD_URING: preadv/pwritev done through Linux io_uring.
+ *
+ * Each pthread gets its own ring the first time it does I/O this way.
+ * A transfer is split into several submission queue entries, one per
+ * run of iobufs, which are submitted together so the device sees all
+ * of them at once. While they are in flight the task yields, so that
+ * other tasks can use the core.
+ *
+ * A task might be moved to another pthread while it waits, and other
+ * tasks on the same pthread might submit to the same ring, so whoever
+ * holds a ring's lock reaps all of its completions and hands each
+ * one to its waiter through the user_data pointer. Waiters only ever
+ * look at the ring they submitted to.
+ *
+ * Where io_uring isn't available (not Linux, old headers or kernel,
+ * or it is disabled) these just call qio_preadv/qio_pwritev, and
+ * choose_io_method never picks QIO_METHOD_URING.
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "sys_basic.h"
+
+#ifndef CHPL_RT_UNIT_TEST
+#include "chplrt.h"
+#include "chpl-tasks.h"
+#endif
+
+#include "qio.h"
+#include "qbuffer.h"
+#include "chpl-thread-local-storage.h"
+
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define QIO_HAS_URING
+#endif
+#endif
+#endif
+
+// How many iobufs a buffered reader asks for at once.
+ssize_t qio_uring_readahead_iobufs = 4;
+
+#ifdef QIO_HAS_URING
+
+// Submission queue size of each ring.
+#define QIO_URING_ENTRIES 64
+
+// Most submission queue entries one transfer keeps in flight.
+#define QIO_URING_MAX_BATCH 16
+
+// How many times a waiter yields before it blocks in the kernel.
+#define QIO_URING_YIELDS 64
+
+typedef struct {
+  pthread_mutex_t lock;
+  int fd;
+  unsigned inflight; // submitted and not yet reaped; under lock
+  unsigned cq_entries;
+
+  unsigned* sq_head;
+  unsigned* sq_tail;
+  unsigned* sq_mask;
+  unsigned* sq_array;
+  struct io_uring_sqe* sqes;
+
+  unsigned* cq_head;
+  unsigned* cq_tail;
+  unsigned* cq_mask;
+  struct io_uring_cqe* cqes;
+} qio_uring_t;
+
+typedef struct {
+  int done;
+  int32_t res;
+} qio_uring_req_t;
+
+static pthread_once_t uring_once = PTHREAD_ONCE_INIT;
+static int uring_ok = 0;
+static CHPL_TLS_DECL(qio_uring_t*, uring_mine);
+
+static
+int uring_setup(unsigned entries, struct io_uring_params* p)
+{
+  return (int) syscall(__NR_io_uring_setup, entries, p);
+}
+
+static
+int uring_enter(int fd, unsigned to_submit, unsigned min_complete,
+                unsigned flags)
+{
+  return (int) syscall(__NR_io_uring_enter, fd, to_submit, min_complete,
+                       flags, NULL, 0);
+}
+
+static
+void uring_yield(void)
+{
+#ifndef CHPL_RT_UNIT_TEST
+  chpl_task_yield();
+#else
+  sched_yield();
+#endif
+}
+
+static
+void uring_probe(void)
+{
+  struct io_uring_params p;
+  int fd;
+
+  CHPL_TLS_INIT(uring_mine);
+
+  memset(&p, 0, sizeof(p));
+  fd = uring_setup(1, &p);
+  if( fd >= 0 ) {
+    close(fd);
+    uring_ok = 1;
+  }
+}
+
+static
+qio_uring_t* uring_create(void)
+{
+  struct io_uring_params p;
+  qio_uring_t* r;
+  size_t sq_len, cq_len, sqes_len;
+  void* sq_ptr;
+  void* cq_ptr;
+  void* sqes;
+  int fd;
+
+  memset(&p, 0, sizeof(p));
+  fd = uring_setup(QIO_URING_ENTRIES, &p);
+  if( fd < 0 ) return NULL;
+
+  sq_len = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+  cq_len = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+  sqes_len = p.sq_entries * sizeof(struct io_uring_sqe);
+
+  sq_ptr = mmap(NULL, sq_len, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+  cq_ptr = mmap(NULL, cq_len, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+  sqes = mmap(NULL, sqes_len, PROT_READ | PROT_WRITE,
+              MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+  r = (qio_uring_t*) qio_calloc(1, sizeof(qio_uring_t));
+
+  if( sq_ptr == MAP_FAILED || cq_ptr == MAP_FAILED || sqes == MAP_FAILED ||
+      r == NULL ) {
+    if( sq_ptr != MAP_FAILED ) munmap(sq_ptr, sq_len);
+    if( cq_ptr != MAP_FAILED ) munmap(cq_ptr, cq_len);
+    if( sqes != MAP_FAILED ) munmap(sqes, sqes_len);
+    if( r ) qio_free(r);
+    close(fd);
+    return NULL;
+  }
+
+  pthread_mutex_init(&r->lock, NULL);
+  r->fd = fd;
+  r->cq_entries = p.cq_entries;
+
+  r->sq_head = (unsigned*) qio_ptr_add(sq_ptr, p.sq_off.head);
+  r->sq_tail = (unsigned*) qio_ptr_add(sq_ptr, p.sq_off.tail);
+  r->sq_mask = (unsigned*) qio_ptr_add(sq_ptr, p.sq_off.ring_mask);
+  r->sq_array = (unsigned*) qio_ptr_add(sq_ptr, p.sq_off.array);
+  r->sqes = (struct io_uring_sqe*) sqes;
+
+  r->cq_head = (unsigned*) qio_ptr_add(cq_ptr, p.cq_off.head);
+  r->cq_tail = (unsigned*) qio_ptr_add(cq_ptr, p.cq_off.tail);
+  r->cq_mask = (unsigned*) qio_ptr_add(cq_ptr, p.cq_off.ring_mask);
+  r->cqes = (struct io_uring_cqe*) qio_ptr_add(cq_ptr, p.cq_off.cqes);
+
+  return r;
+}
+
+// Returns this pthread's ring, creating it if need be, or NULL
+// if io_uring can't be used.
+static
+qio_uring_t* uring_get(void)
+{
+  qio_uring_t* r;
+
+  pthread_once(&uring_once, uring_probe);
+  if( ! uring_ok ) return NULL;
+
+  r = (qio_uring_t*) CHPL_TLS_GET(uring_mine);
+  if( r == NULL ) {
+    r = uring_create();
+    CHPL_TLS_SET(uring_mine, r);
+  }
+  return r;
+}
+
+// Hand every available completion to its waiter. Call with r->lock held.
+static
+void uring_reap_locked(qio_uring_t* r)
+{
+  unsigned head = *r->cq_head;
+  unsigned tail = __atomic_load_n(r->cq_tail, __ATOMIC_ACQUIRE);
+
+  while( head != tail ) {
+    struct io_uring_cqe* cqe = &r->cqes[head & *r->cq_mask];
+    qio_uring_req_t* req = (qio_uring_req_t*) (intptr_t) cqe->user_data;
+    req->res = cqe->res;
+    __atomic_store_n(&req->done, 1, __ATOMIC_RELEASE);
+    head++;
+    r->inflight--;
+  }
+
+  __atomic_store_n(r->cq_head, head, __ATOMIC_RELEASE);
+}
+
+static
+int uring_all_done(qio_uring_req_t* reqs, int n, int* first_pending)
+{
+  while( *first_pending < n &&
+         __atomic_load_n(&reqs[*first_pending].done, __ATOMIC_ACQUIRE) )
+    (*first_pending)++;
+  return *first_pending == n;
+}
+
+// Wait for all of reqs to complete, yielding while we do. If nothing
+// turns up after a while, block in the kernel instead. That is done
+// while holding the lock so that nobody else can reap our completion
+// out from under us and leave us waiting for one that never comes.
+static
+void uring_wait(qio_uring_t* r, qio_uring_req_t* reqs, int n)
+{
+  int pending = 0;
+  int yields = 0;
+
+  while( ! uring_all_done(reqs, n, &pending) ) {
+    if( yields < QIO_URING_YIELDS ) {
+      if( pthread_mutex_trylock(&r->lock) == 0 ) {
+        uring_reap_locked(r);
+        pthread_mutex_unlock(&r->lock);
+      }
+      if( ! uring_all_done(reqs, n, &pending) ) {
+        uring_yield();
+        yields++;
+      }
+    } else {
+      pthread_mutex_lock(&r->lock);
+      uring_reap_locked(r);
+      if( ! uring_all_done(reqs, n, &pending) ) {
+        uring_enter(r->fd, 0, 1, IORING_ENTER_GETEVENTS);
+        uring_reap_locked(r);
+      }
+      pthread_mutex_unlock(&r->lock);
+      yields = 0;
+    }
+  }
+}
+
+// Submit n vectored reads or writes, the i'th of which covers
+// iovs[i] for cnts[i] iovecs at file offset offs[i]. Returns how many
+// were submitted; if that is less than n, *err_out says why.
+static
+int uring_submit(qio_uring_t* r, int fd, int writing,
+                 struct iovec** iovs, int* cnts, int64_t* offs,
+                 qio_uring_req_t* reqs, int n, qioerr* err_out)
+{
+  unsigned tail, mask;
+  int i, got;
+
+  *err_out = 0;
+
+  pthread_mutex_lock(&r->lock);
+
+  // Never have more in flight than the completion queue can hold.
+  while( r->inflight + n > r->cq_entries ) {
+    uring_reap_locked(r);
+    if( r->inflight + n <= r->cq_entries ) break;
+    pthread_mutex_unlock(&r->lock);
+    uring_yield();
+    pthread_mutex_lock(&r->lock);
+  }
+
+  tail = *r->sq_tail;
+  mask = *r->sq_mask;
+  for( i = 0; i < n; i++ ) {
+    unsigned idx = (tail + i) & mask;
+    struct io_uring_sqe* sqe = &r->sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = writing ? IORING_OP_WRITEV : IORING_OP_READV;
+    sqe->fd = fd;
+    sqe->addr = (uint64_t) (intptr_t) iovs[i];
+    sqe->len = cnts[i];
+    sqe->off = offs[i];
+    sqe->user_data = (uint64_t) (intptr_t) &reqs[i];
+    r->sq_array[idx] = idx;
+    reqs[i].done = 0;
+  }
+  __atomic_store_n(r->sq_tail, tail + n, __ATOMIC_RELEASE);
+
+  // Without SQPOLL the kernel consumes everything we submit here,
+  // unless it is short of memory or similar.
+  i = 0;
+  while( i < n ) {
+    got = uring_enter(r->fd, n - i, 0, 0);
+    if( got < 0 ) {
+      if( errno == EINTR || errno == EAGAIN || errno == EBUSY ) {
+        uring_reap_locked(r);
+        continue;
+      }
+      // Take back what the kernel didn't consume. It only looks at
+      // the submission queue inside io_uring_enter, and we hold the
+      // lock, so that is safe.
+      *err_out = qio_int_to_err(errno);
+      __atomic_store_n(r->sq_tail, tail + i, __ATOMIC_RELEASE);
+      break;
+    }
+    i += got;
+  }
+  r->inflight += i;
+
+  pthread_mutex_unlock(&r->lock);
+  return i;
+}
+
+static
+qioerr uring_rwv(qio_file_t* file, int writing, qbuffer_t* buf,
+                 qbuffer_iter_t start, qbuffer_iter_t end,
+                 int64_t seek_to_offset, ssize_t* num_out)
+{
+  qio_uring_t* r;
+  int64_t num_bytes = qbuffer_iter_num_bytes(start, end);
+  ssize_t num_parts = qbuffer_iter_num_parts(start, end);
+  struct iovec* iov = NULL;
+  size_t iovcnt;
+  MAYBE_STACK_SPACE(struct iovec, iov_onstack);
+  struct iovec* iovs[QIO_URING_MAX_BATCH];
+  int cnts[QIO_URING_MAX_BATCH];
+  int64_t offs[QIO_URING_MAX_BATCH];
+  ssize_t lens[QIO_URING_MAX_BATCH];
+  qio_uring_req_t reqs[QIO_URING_MAX_BATCH];
+  size_t per, done_iovs;
+  int n, i;
+  int64_t off;
+  ssize_t total = 0;
+  qioerr err;
+
+  r = (file->fd == -1) ? NULL : uring_get();
+  if( r == NULL ) {
+    if( writing )
+      return qio_pwritev(file, buf, start, end, seek_to_offset, num_out);
+    else
+      return qio_preadv(file, buf, start, end, seek_to_offset, num_out);
+  }
+
+  *num_out = 0;
+
+  if( num_bytes < 0 || num_parts < 0 || num_parts > INT_MAX ) {
+    QIO_RETURN_CONSTANT_ERROR(EINVAL, "range outside of buffer");
+  }
+
+  MAYBE_STACK_ALLOC(struct iovec, num_parts, iov, iov_onstack);
+  if( ! iov ) return QIO_ENOMEM;
+
+  err = qbuffer_to_iov(buf, start, end, num_parts, iov, NULL, &iovcnt);
+  if( err ) goto error;
+
+  if( iovcnt == 0 ) goto error;
+
+  // Split the iovecs into up to QIO_URING_MAX_BATCH requests of
+  // similar size. If there are more than that many IOV_MAX-sized
+  // runs we transfer only the first part; callers loop anyway.
+  per = (iovcnt + QIO_URING_MAX_BATCH - 1) / QIO_URING_MAX_BATCH;
+  if( per > IOV_MAX ) per = IOV_MAX;
+
+  off = seek_to_offset;
+  done_iovs = 0;
+  for( n = 0; n < QIO_URING_MAX_BATCH && done_iovs < iovcnt; n++ ) {
+    size_t cnt = iovcnt - done_iovs;
+    if( cnt > per ) cnt = per;
+    iovs[n] = &iov[done_iovs];
+    cnts[n] = (int) cnt;
+    offs[n] = off;
+    lens[n] = sys_iov_total_bytes(iovs[n], cnts[n]);
+    off += lens[n];
+    done_iovs += cnt;
+  }
+
+  // If not all could be submitted, we still have to wait for those
+  // that were, since they refer to iov and reqs.
+  n = uring_submit(r, file->fd, writing, iovs, cnts, offs, reqs, n, &err);
+  uring_wait(r, reqs, n);
+  if( err && n == 0 ) goto error;
+  err = 0;
+
+  // Report only the leading run of data that was transferred in full.
+  // Anything after a short transfer is done again by the caller.
+  for( i = 0; i < n; i++ ) {
+    if( reqs[i].res < 0 ) {
+      if( total == 0 ) err = qio_int_to_err(-reqs[i].res);
+      break;
+    }
+    total += reqs[i].res;
+    if( reqs[i].res < lens[i] ) break;
+  }
+
+  if( ! writing && ! err && total == 0 && num_bytes != 0 ) err = QIO_EEOF;
+
+error:
+  MAYBE_STACK_FREE(iov, iov_onstack);
+
+  *num_out = total;
+
+  return err;
+}
+
+int qio_uring_available(void)
+{
+  pthread_once(&uring_once, uring_probe);
+  return uring_ok;
+}
+
+#else
+
+int qio_uring_available(void)
+{
+  return 0;
+}
+
+static
+qioerr uring_rwv(qio_file_t* file, int writing, qbuffer_t* buf,
+                 qbuffer_iter_t start, qbuffer_iter_t end,
+                 int64_t seek_to_offset, ssize_t* num_out)
+{
+  if( writing )
+    return qio_pwritev(file, buf, start, end, seek_to_offset, num_out);
+  else
+    return qio_preadv(file, buf, start, end, seek_to_offset, num_out);
+}
+
+#endif
+
+qioerr qio_uring_preadv(qio_file_t* file, qbuffer_t* buf, qbuffer_iter_t start, qbuffer_iter_t end, int64_t seek_to_offset, ssize_t* num_read)
+{
+  return uring_rwv(file, 0, buf, start, end, seek_to_offset, num_read);
+}
+
+qioerr qio_uring_pwritev(qio_file_t* file, qbuffer_t* buf, qbuffer_iter_t start, qbuffer_iter_t end, int64_t seek_to_offset, ssize_t* num_written)
+{
+  return uring_rwv(file, 1, buf, start, end, seek_to_offset, num_written);
+}
@@ -24,7 +24,9 @@
 #include "chplrt.h"
 #include "chpl_rt_utils_static.h"
 #include "chplcgfns.h"
+#include "chpl-atomics.h"
 #include "chpl-comm.h"
+#include "chpl-env.h"
 #include "chplexit.h"
 #include "chpl-locale-model.h"
 #include "chpl-mem.h"
@@ -43,6 +45,11 @@
 #include <sys/mman.h>
 #include <unistd.h>
 #include <math.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#define FIFO_SYNC_USE_FUTEX 1
+#endif
 
 
 //
@@ -76,10 +83,45 @@ typedef struct lockReport {
 } lockReport_t;
 
 
+//
+// Work-stealing task pool.
+//
+// When CHPL_RT_FIFO_WORK_STEALING is set, each thread that runs tasks
+// (plus the main thread) owns a Chase-Lev deque.  A thread pushes the
+// tasks it creates onto the bottom of its own deque and pops from
+// there too, while idle threads steal from the tops of randomly chosen
+// other deques.  Tasks created by threads that don't have a deque (the
+// comm thread, or threads beyond WS_MAX_DEQUES) go into the original
+// global task pool, which then serves as an injection queue.  None of
+// this needs threading_lock except that injection queue.
+//
+// Deque arrays grow by doubling.  A thief may still be looking at the
+// old array when it is replaced, so old arrays are kept (chained off
+// the new one) rather than freed.  Their total size is less than that
+// of the current array.
+//
+#define WS_INITIAL_DEQUE_SIZE 64
+#define WS_MAX_DEQUES 1024
+
+typedef struct ws_array_s {
+  int64_t            size;      // always a power of 2
+  struct ws_array_s* prev;      // the smaller array this one replaced
+  atomic_uintptr_t   slots[];   // task_pool_p values
+} ws_array_t;
+
+typedef struct {
+  atomic_int_least64_t top;     // thieves take from here
+  atomic_int_least64_t bottom;  // the owner pushes and pops here
+  atomic_uintptr_t     array;   // ws_array_t*
+} ws_deque_t;
+
+
 // This is the data that is private to each thread.
 typedef struct {
   task_pool_p   ptask;
   lockReport_t* lockRprt;
+  ws_deque_t*   deque;          // work-stealing deque, if any
+  uint32_t      steal_seed;     // for choosing steal victims
 } thread_private_data_t;
 
 
@@ -87,19 +129,20 @@ static chpl_bool        initialized = false;
 
 static chpl_thread_mutex_t threading_lock;     // critical section lock
 static chpl_thread_mutex_t extra_task_lock;    // critical section lock
-static chpl_thread_mutex_t task_id_lock;       // critical section lock
 static chpl_thread_mutex_t task_list_lock;     // critical section lock
 static volatile task_pool_p
                            task_pool_head;     // head of task pool
 static volatile task_pool_p
                            task_pool_tail;     // tail of task pool
 
-static int                 queued_task_cnt;    // number of tasks in task pool
+static atomic_int_least32_t
+                           queued_task_cnt;    // number of tasks in task pool
 static int64_t             extra_task_cnt;     // number of tasks being run by
                                                //   threads occupied already
 static int                 blocked_thread_cnt; // number of threads that
                                                //   cannot make progress
-static int                 idle_thread_cnt;    // number of threads looking
+static atomic_int_least32_t
+                           idle_thread_cnt;    // number of threads looking
                                                //   for work
 static uint64_t            progress_cnt;       // number of unblock operations,
                                                //   as a proxy for progress
@@ -113,11 +156,21 @@ static chpl_thread_mutex_t taskTable_lock;     // critical section lock
 
 static chpl_fn_p comm_task_fn;
 
+static chpl_bool           work_stealing;      // use per-thread deques?
+static atomic_uintptr_t    ws_deques[WS_MAX_DEQUES];
+static atomic_int_least32_t
+                           ws_num_deques;      // deques handed out so far
+
 //
 // Internal functions.
 //
 static void                    enqueue_task(task_pool_p, task_pool_p*);
 static void                    dequeue_task(task_pool_p);
+static ws_deque_t*             ws_new_deque(void);
+static void                    ws_push(ws_deque_t*, task_pool_p);
+static task_pool_p             ws_pop(ws_deque_t*);
+static task_pool_p             ws_take_task(thread_private_data_t*);
+static void                    run_listed_task(task_pool_p, task_pool_p);
 static void                    comm_task_wrapper(void*);
 static void                    taskCallBody(chpl_fn_int_t, chpl_fn_p,
                                             chpl_task_bundle_t*, size_t,
@@ -156,38 +209,70 @@ static void chpl_thread_sync_awaken(chpl_sync_aux_t *s);
 
 // Sync variables
 
+//
+// A task waiting for a sync variable first spins for a while, since
+// in producer/consumer code the other side is often about to act and
+// parking the thread costs far more than the wait.  It checks the
+// state FIFO_SYNC_SPIN_PAUSES times with a cpu pause in between, then
+// FIFO_SYNC_SPIN_YIELDS more times with a sched_yield() in between,
+// and if the variable still isn't in the state it wants it parks until
+// signaled.  If we're oversubscribing the hardware the thread we're
+// waiting for may need our processor, so we skip the spin and park
+// right away.
+//
+#define FIFO_SYNC_SPIN_PAUSES 1000
+#define FIFO_SYNC_SPIN_YIELDS 16
+
+static inline void sync_spin_pause(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  __asm__ __volatile__ ("pause" ::: "memory");
+#elif defined(__aarch64__)
+  __asm__ __volatile__ ("yield" ::: "memory");
+#else
+  __asm__ __volatile__ ("" ::: "memory");
+#endif
+}
+
+static chpl_bool sync_spin_wait(chpl_sync_aux_t *s, chpl_bool want_full) {
+  int i;
+
+  for (i = 0; i < FIFO_SYNC_SPIN_PAUSES; i++) {
+    if (s->is_full == want_full)
+      return true;
+    sync_spin_pause();
+  }
+
+  for (i = 0; i < FIFO_SYNC_SPIN_YIELDS; i++) {
+    if (s->is_full == want_full)
+      return true;
+    chpl_thread_yield();
+  }
+
+  return s->is_full == want_full;
+}
+
 static void sync_wait_and_lock(chpl_sync_aux_t *s,
                                chpl_bool want_full,
                                int32_t lineno, int32_t filename) {
-  chpl_bool suspend_using_cond;
-
   chpl_thread_mutexLock(&s->lock);
 
-  // If we're oversubscribing the hardware, we wait using conditionals
-  // in order to ensure fairness and thus progress.  If we're not, we
-  // can spin-wait.
-  suspend_using_cond = (chpl_thread_getNumThreads() >=
-                        chpl_topo_getNumCPUsLogical(true));
+  if (s->is_full != want_full
+      && chpl_thread_getNumThreads() < chpl_topo_getNumCPUsLogical(true)) {
+    chpl_thread_mutexUnlock(&s->lock);
+    (void) sync_spin_wait(s, want_full);
+    chpl_thread_mutexLock(&s->lock);
+  }
 
   while (s->is_full != want_full) {
-    if (!suspend_using_cond) {
-      chpl_thread_mutexUnlock(&s->lock);
-    }
     if (set_block_loc(lineno, filename)) {
       // all other tasks appear to be blocked
       struct timeval deadline, now;
       chpl_bool timed_out = false;
-      // default value so that always allows condition to be true if not
-      // using conditionals
 
       gettimeofday(&deadline, NULL);
       deadline.tv_sec += 1;
       do {
-        if (suspend_using_cond)
-          timed_out = chpl_thread_sync_suspend(s, &deadline);
-        else
-          chpl_thread_yield();
-        
+        timed_out = chpl_thread_sync_suspend(s, &deadline);
         if (s->is_full != want_full && !timed_out)
           gettimeofday(&now, NULL);
       } while (s->is_full != want_full
@@ -200,15 +285,10 @@ static void sync_wait_and_lock(chpl_sync_aux_t *s,
     }
     else {
       do {
-        if (suspend_using_cond)
-          (void) chpl_thread_sync_suspend(s, NULL);
-        else
-          chpl_thread_yield();
+        (void) chpl_thread_sync_suspend(s, NULL);
       } while (s->is_full != want_full);
     }
     unset_block_loc();
-    if (!suspend_using_cond)
-      chpl_thread_mutexLock(&s->lock);
   }
 
   if (blockreport)
@@ -233,8 +313,51 @@ void chpl_sync_waitEmptyAndLock(chpl_sync_aux_t *s,
   sync_wait_and_lock(s, false, lineno, filename);
 }
 
+//
+// Park until the sync variable may have changed state, or the deadline
+// (if any) passes.  Called and returns with s->lock held.  Returns
+// true if we timed out.
+//
 static chpl_bool chpl_thread_sync_suspend(chpl_sync_aux_t *s,
                                    struct timeval *deadline) {
+#ifdef FIFO_SYNC_USE_FUTEX
+  chpl_bool want_full = !s->is_full;
+  volatile uint32_t* seq = want_full ? &s->full_seq : &s->empty_seq;
+  int32_t* waiters = want_full ? &s->full_waiters : &s->empty_waiters;
+  uint32_t seen = *seq;
+  struct timespec ts;
+  struct timespec* tsp = NULL;
+  chpl_bool timed_out = false;
+
+  if (deadline != NULL) {
+    struct timeval now;
+    int64_t usec;
+
+    gettimeofday(&now, NULL);
+    usec = (int64_t) (deadline->tv_sec - now.tv_sec) * 1000000
+           + (deadline->tv_usec - now.tv_usec);
+    if (usec <= 0)
+      return true;
+    ts.tv_sec  = usec / 1000000;
+    ts.tv_nsec = (usec % 1000000) * 1000;
+    tsp = &ts;
+  }
+
+  //
+  // If the variable changes state after we drop the lock but before
+  // we're in the kernel, the sequence number won't match and the wait
+  // returns immediately.
+  //
+  (*waiters)++;
+  chpl_thread_mutexUnlock(&s->lock);
+  if (syscall(SYS_futex, seq, FUTEX_WAIT_PRIVATE, seen, tsp, NULL, 0) != 0
+      && errno == ETIMEDOUT)
+    timed_out = true;
+  chpl_thread_mutexLock(&s->lock);
+  (*waiters)--;
+
+  return timed_out;
+#else
   chpl_thread_condvar_t* cond;
   cond = s->is_full ? &s->signal_empty : &s->signal_full;
 
@@ -249,12 +372,28 @@ static chpl_bool chpl_thread_sync_suspend(chpl_sync_aux_t *s,
     return (pthread_cond_timedwait(cond, (pthread_mutex_t*) &s->lock, &ts)
             == ETIMEDOUT);
   }
+#endif
 }
 
+//
+// Wake one waiter for the state the sync variable is now in.  Called
+// with s->lock held.
+//
 static void chpl_thread_sync_awaken(chpl_sync_aux_t *s) {
+#ifdef FIFO_SYNC_USE_FUTEX
+  volatile uint32_t* seq = s->is_full ? &s->full_seq : &s->empty_seq;
+  int32_t waiters = s->is_full ? s->full_waiters : s->empty_waiters;
+
+  (*seq)++;
+  if (waiters > 0) {
+    if (syscall(SYS_futex, seq, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0) < 0)
+      chpl_internal_error("futex wake failed");
+  }
+#else
   if (pthread_cond_signal(s->is_full ?
                           &s->signal_full : &s->signal_empty))
     chpl_internal_error("pthread_cond_signal() failed");
+#endif
 }
 
 void chpl_sync_markAndSignalFull(chpl_sync_aux_t *s) {
@@ -281,6 +420,10 @@ static void chpl_thread_condvar_init(chpl_thread_condvar_t* cv) {
 
 void chpl_sync_initAux(chpl_sync_aux_t *s) {
   s->is_full = false;
+  s->full_seq = 0;
+  s->empty_seq = 0;
+  s->full_waiters = 0;
+  s->empty_waiters = 0;
   chpl_thread_mutexInit(&s->lock);
   chpl_thread_condvar_init(&s->signal_full);
   chpl_thread_condvar_init(&s->signal_empty);
@@ -322,6 +465,11 @@ static void setup_main_thread_private_data(void)
   tp->ptask->bundle.requested_fn    = NULL;
   tp->ptask->bundle.id              = get_next_task_id();
 
+  if (work_stealing) {
+    tp->deque = ws_new_deque();
+    tp->steal_seed = (uint32_t) (intptr_t) tp | 1;
+  }
+
   chpl_thread_setPrivateData(tp);
 }
 
@@ -331,14 +479,18 @@ static void setup_main_thread_private_data(void)
 void chpl_task_init(void) {
   chpl_thread_mutexInit(&threading_lock);
   chpl_thread_mutexInit(&extra_task_lock);
-  chpl_thread_mutexInit(&task_id_lock);
   chpl_thread_mutexInit(&task_list_lock);
-  queued_task_cnt = 0;
+  atomic_init_int_least32_t(&queued_task_cnt, 0);
   blocked_thread_cnt = 0;
-  idle_thread_cnt = 0;
+  atomic_init_int_least32_t(&idle_thread_cnt, 0);
   extra_task_cnt = 0;
   task_pool_head = task_pool_tail = NULL;
 
+  work_stealing = chpl_env_rt_get_bool("FIFO_WORK_STEALING", false);
+  for (int i = 0; i < WS_MAX_DEQUES; i++)
+    atomic_init_uintptr_t(&ws_deques[i], (uintptr_t) NULL);
+  atomic_init_int_least32_t(&ws_num_deques, 0);
+
   chpl_thread_init(thread_begin, thread_end);
 
   //
@@ -521,7 +673,7 @@ static void comm_task_wrapper(void* arg) {
 //
 static inline
 void enqueue_task(task_pool_p ptask, task_pool_p* p_task_list_head) {
-  queued_task_cnt++;
+  (void) atomic_fetch_add_int_least32_t(&queued_task_cnt, 1);
 
   //
   // Add to pool.
@@ -552,8 +704,8 @@ void enqueue_task(task_pool_p ptask, task_pool_p* p_task_list_head) {
 
 static inline
 void dequeue_task(task_pool_p ptask) {
-  assert(queued_task_cnt > 0);
-  queued_task_cnt--;
+  assert(atomic_load_int_least32_t(&queued_task_cnt) > 0);
+  (void) atomic_fetch_sub_int_least32_t(&queued_task_cnt, 1);
 
   //
   // Remove from pool.
@@ -585,6 +737,232 @@ void dequeue_task(task_pool_p ptask) {
 }
 
 
+//
+// Work-stealing deques.  Only the owning thread calls ws_push() and
+// ws_pop(); any thread may call ws_steal().
+//
+static ws_array_t* ws_new_array(int64_t size, ws_array_t* prev) {
+  ws_array_t* a;
+
+  a = (ws_array_t*) chpl_mem_alloc(sizeof(ws_array_t)
+                                   + size * sizeof(atomic_uintptr_t),
+                                   CHPL_RT_MD_TASK_POOL_DESC, 0, 0);
+  a->size = size;
+  a->prev = prev;
+  return a;
+}
+
+
+//
+// Create a deque and make it visible to thieves.  Returns NULL if
+// there are already as many deques as we have room for.
+//
+static ws_deque_t* ws_new_deque(void) {
+  int32_t i;
+  ws_deque_t* d;
+
+  i = atomic_fetch_add_int_least32_t(&ws_num_deques, 1);
+  if (i >= WS_MAX_DEQUES)
+    return NULL;
+
+  d = (ws_deque_t*) chpl_mem_alloc(sizeof(ws_deque_t),
+                                   CHPL_RT_MD_TASK_POOL_DESC, 0, 0);
+  atomic_init_int_least64_t(&d->top, 0);
+  atomic_init_int_least64_t(&d->bottom, 0);
+  atomic_init_uintptr_t(&d->array,
+                        (uintptr_t) ws_new_array(WS_INITIAL_DEQUE_SIZE,
+                                                 NULL));
+  atomic_store_uintptr_t(&ws_deques[i], (uintptr_t) d);
+  return d;
+}
+
+
+static void ws_push(ws_deque_t* d, task_pool_p ptask) {
+  int64_t b = atomic_load_int_least64_t(&d->bottom);
+  int64_t t = atomic_load_int_least64_t(&d->top);
+  ws_array_t* a = (ws_array_t*) atomic_load_uintptr_t(&d->array);
+
+  if (b - t > a->size - 1) {
+    ws_array_t* na = ws_new_array(2 * a->size, a);
+    for (int64_t i = t; i < b; i++)
+      atomic_store_uintptr_t(&na->slots[i & (na->size - 1)],
+                             atomic_load_uintptr_t(&a->slots[i
+                                                              & (a->size - 1)]));
+    atomic_store_uintptr_t(&d->array, (uintptr_t) na);
+    a = na;
+  }
+
+  atomic_store_uintptr_t(&a->slots[b & (a->size - 1)], (uintptr_t) ptask);
+  atomic_store_int_least64_t(&d->bottom, b + 1);
+}
+
+
+static task_pool_p ws_pop(ws_deque_t* d) {
+  int64_t b = atomic_load_int_least64_t(&d->bottom) - 1;
+  ws_array_t* a = (ws_array_t*) atomic_load_uintptr_t(&d->array);
+  int64_t t;
+  task_pool_p ptask = NULL;
+
+  atomic_store_int_least64_t(&d->bottom, b);
+  t = atomic_load_int_least64_t(&d->top);
+  if (t <= b) {
+    ptask = (task_pool_p) atomic_load_uintptr_t(&a->slots[b & (a->size - 1)]);
+    if (t == b) {
+      // This is the last one; a thief may be after it too.
+      if (!atomic_compare_exchange_strong_int_least64_t(&d->top, t, t + 1))
+        ptask = NULL;
+      atomic_store_int_least64_t(&d->bottom, b + 1);
+    }
+  }
+  else {
+    atomic_store_int_least64_t(&d->bottom, b + 1);
+  }
+
+  return ptask;
+}
+
+
+static task_pool_p ws_steal(ws_deque_t* d) {
+  int64_t t = atomic_load_int_least64_t(&d->top);
+  int64_t b = atomic_load_int_least64_t(&d->bottom);
+
+  if (t < b) {
+    ws_array_t* a = (ws_array_t*) atomic_load_uintptr_t(&d->array);
+    task_pool_p ptask =
+      (task_pool_p) atomic_load_uintptr_t(&a->slots[t & (a->size - 1)]);
+    if (atomic_compare_exchange_strong_int_least64_t(&d->top, t, t + 1))
+      return ptask;
+  }
+
+  return NULL;
+}
+
+
+//
+// Add a task to the work-stealing pool: the calling thread's own deque
+// if it has one, otherwise the injection queue.
+//
+static void ws_enqueue_task(task_pool_p ptask, task_pool_p* p_task_list_head) {
+  thread_private_data_t* tp = chpl_thread_getPrivateData();
+
+  if (tp != NULL && tp->deque != NULL) {
+    // The list head is only used to recognize the list's tasks when
+    // they are popped again in chpl_task_executeTasksInList().
+    ptask->p_list_head = p_task_list_head;
+    (void) atomic_fetch_add_int_least32_t(&queued_task_cnt, 1);
+    ws_push(tp->deque, ptask);
+  }
+  else {
+    // Keep the task on its list, so that the list's creator can still
+    // run it itself.
+    chpl_thread_mutexLock(&threading_lock);
+    enqueue_task(ptask, p_task_list_head);
+    chpl_thread_mutexUnlock(&threading_lock);
+  }
+}
+
+
+//
+// Pop the most recently pushed task on the given list from our deque,
+// or return NULL if none of its tasks are left there.  Tasks above it
+// that belong to others (begins from the list's tasks, or the tasks of
+// an enclosing list) are put back as they were.
+//
+static task_pool_p ws_pop_list_task(ws_deque_t* d,
+                                    task_pool_p* p_task_list_head) {
+  task_pool_p others_buf[16];
+  task_pool_p* others = others_buf;
+  int others_size = sizeof(others_buf) / sizeof(others_buf[0]);
+  int num_others = 0;
+  task_pool_p ptask;
+
+  while ((ptask = ws_pop(d)) != NULL
+         && ptask->p_list_head != p_task_list_head) {
+    if (num_others == others_size) {
+      task_pool_p* new_others;
+
+      new_others = (task_pool_p*) chpl_mem_allocMany(2 * others_size,
+                                                     sizeof(others[0]),
+                                                     CHPL_RT_MD_TASK_POOL_DESC,
+                                                     0, 0);
+      memcpy(new_others, others, num_others * sizeof(others[0]));
+      if (others != others_buf)
+        chpl_mem_free(others, 0, 0);
+      others = new_others;
+      others_size *= 2;
+    }
+    others[num_others++] = ptask;
+  }
+
+  while (num_others > 0)
+    ws_push(d, others[--num_others]);
+
+  if (others != others_buf)
+    chpl_mem_free(others, 0, 0);
+
+  return ptask;
+}
+
+
+//
+// Find a task to run: first our own deque, then the injection queue,
+// then other threads' deques starting from a random one.
+//
+static task_pool_p ws_take_task(thread_private_data_t* tp) {
+  task_pool_p ptask;
+  int32_t num_deques;
+  int32_t start;
+  uint32_t x;
+
+  if (tp->deque != NULL && (ptask = ws_pop(tp->deque)) != NULL) {
+    (void) atomic_fetch_sub_int_least32_t(&queued_task_cnt, 1);
+    return ptask;
+  }
+
+  if (task_pool_head != NULL) {
+    chpl_thread_mutexLock(&threading_lock);
+    if ((ptask = task_pool_head) != NULL)
+      dequeue_task(ptask);
+    chpl_thread_mutexUnlock(&threading_lock);
+    if (ptask != NULL)
+      return ptask;
+  }
+
+  num_deques = atomic_load_int_least32_t(&ws_num_deques);
+  if (num_deques > WS_MAX_DEQUES)
+    num_deques = WS_MAX_DEQUES;
+  if (num_deques == 0)
+    return NULL;
+
+  // xorshift32
+  x = tp->steal_seed;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  tp->steal_seed = x;
+
+  start = (int32_t) (x % (uint32_t) num_deques);
+  for (int32_t i = 0; i < num_deques; i++) {
+    ws_deque_t* d =
+      (ws_deque_t*) atomic_load_uintptr_t(&ws_deques[(start + i)
+                                                     % num_deques]);
+    if (d != NULL && d != tp->deque && (ptask = ws_steal(d)) != NULL) {
+      (void) atomic_fetch_sub_int_least32_t(&queued_task_cnt, 1);
+      return ptask;
+    }
+  }
+
+  return NULL;
+}
+
+
+static inline chpl_bool task_pool_is_empty(void) {
+  if (work_stealing)
+    return atomic_load_int_least32_t(&queued_task_cnt) == 0;
+  return task_pool_head == NULL;
+}
+
+
 void chpl_task_addToTaskList(chpl_fn_int_t fid,
                              chpl_task_bundle_t* arg, size_t arg_size,
                              c_sublocid_t subloc,
@@ -595,8 +973,9 @@ void chpl_task_addToTaskList(chpl_fn_int_t fid,
                              int32_t filename) {
   assert(subloc == c_sublocid_any);
 
-  // begin critical section
-  chpl_thread_mutexLock(&threading_lock);
+  // begin critical section (the work-stealing pool doesn't need one)
+  if (!work_stealing)
+    chpl_thread_mutexLock(&threading_lock);
 
   if (task_list_locale == chpl_nodeID) {
     (void) add_to_task_pool(fid, chpl_ftable[fid], arg, arg_size,
@@ -616,7 +995,8 @@ void chpl_task_addToTaskList(chpl_fn_int_t fid,
   }
 
   // end critical section
-  chpl_thread_mutexUnlock(&threading_lock);
+  if (!work_stealing)
+    chpl_thread_mutexUnlock(&threading_lock);
 }
 
 
@@ -630,78 +1010,102 @@ void chpl_task_executeTasksInList(void** p_task_list_void) {
 
   curr_ptask = get_current_ptask();
 
-  while (*p_task_list_head != NULL) {
-    chpl_fn_p task_to_run_fun = NULL;
+  if (work_stealing) {
+    //
+    // The list's tasks that haven't been stolen are still in our own
+    // deque, perhaps under tasks that belong to others.  Run them all
+    // before returning: if every thread is blocked, nobody else will.
+    // If we don't have a deque they went to the injection queue on the
+    // list, and we run them from there as in the plain fifo pool.
+    //
+    thread_private_data_t* tp = get_thread_private_data();
 
+    if (tp->deque != NULL) {
+      while ((child_ptask = ws_pop_list_task(tp->deque,
+                                             p_task_list_head)) != NULL) {
+        (void) atomic_fetch_sub_int_least32_t(&queued_task_cnt, 1);
+        run_listed_task(curr_ptask, child_ptask);
+      }
+      return;
+    }
+  }
+
+  while (*p_task_list_head != NULL) {
     // begin critical section
     chpl_thread_mutexLock(&threading_lock);
 
-    if ((child_ptask = *p_task_list_head) != NULL) {
-      task_to_run_fun = child_ptask->bundle.requested_fn;
+    if ((child_ptask = *p_task_list_head) != NULL)
       dequeue_task(child_ptask);
-    }
 
     // end critical section
     chpl_thread_mutexUnlock(&threading_lock);
 
-    if (task_to_run_fun == NULL)
-      continue;
+    if (child_ptask != NULL)
+      run_listed_task(curr_ptask, child_ptask);
+  }
+}
 
-    set_current_ptask(child_ptask);
 
-    // begin critical section
-    chpl_thread_mutexLock(&extra_task_lock);
+//
+// Run a task from a task list on the current thread, on behalf of the
+// task (curr_ptask) that created the list.
+//
+static void run_listed_task(task_pool_p curr_ptask, task_pool_p child_ptask) {
+  chpl_fn_p task_to_run_fun = child_ptask->bundle.requested_fn;
 
-    extra_task_cnt++;
+  set_current_ptask(child_ptask);
 
-    // end critical section
-    chpl_thread_mutexUnlock(&extra_task_lock);
+  // begin critical section
+  chpl_thread_mutexLock(&extra_task_lock);
 
-    if (do_taskReport) {
-      chpl_thread_mutexLock(&taskTable_lock);
-      chpldev_taskTable_set_suspended(curr_ptask->bundle.id);
-      chpldev_taskTable_set_active(child_ptask->bundle.id);
-      chpl_thread_mutexUnlock(&taskTable_lock);
-    }
+  extra_task_cnt++;
 
-    if (blockreport)
-      initializeLockReportForThread();
+  // end critical section
+  chpl_thread_mutexUnlock(&extra_task_lock);
 
-    chpl_task_do_callbacks(chpl_task_cb_event_kind_begin,
-                           child_ptask->bundle.requested_fid,
-                           child_ptask->bundle.filename,
-                           child_ptask->bundle.lineno,
-                           child_ptask->bundle.id,
-                           child_ptask->bundle.is_executeOn);
+  if (do_taskReport) {
+    chpl_thread_mutexLock(&taskTable_lock);
+    chpldev_taskTable_set_suspended(curr_ptask->bundle.id);
+    chpldev_taskTable_set_active(child_ptask->bundle.id);
+    chpl_thread_mutexUnlock(&taskTable_lock);
+  }
+
+  if (blockreport)
+    initializeLockReportForThread();
 
-    (*task_to_run_fun)(&child_ptask->bundle);
+  chpl_task_do_callbacks(chpl_task_cb_event_kind_begin,
+                         child_ptask->bundle.requested_fid,
+                         child_ptask->bundle.filename,
+                         child_ptask->bundle.lineno,
+                         child_ptask->bundle.id,
+                         child_ptask->bundle.is_executeOn);
 
-    chpl_task_do_callbacks(chpl_task_cb_event_kind_end,
-                           child_ptask->bundle.requested_fid,
-                           child_ptask->bundle.filename,
-                           child_ptask->bundle.lineno,
-                           child_ptask->bundle.id,
-                           child_ptask->bundle.is_executeOn);
+  (*task_to_run_fun)(&child_ptask->bundle);
 
-    if (do_taskReport) {
-      chpl_thread_mutexLock(&taskTable_lock);
-      chpldev_taskTable_set_active(curr_ptask->bundle.id);
-      chpldev_taskTable_remove(child_ptask->bundle.id);
-      chpl_thread_mutexUnlock(&taskTable_lock);
-    }
+  chpl_task_do_callbacks(chpl_task_cb_event_kind_end,
+                         child_ptask->bundle.requested_fid,
+                         child_ptask->bundle.filename,
+                         child_ptask->bundle.lineno,
+                         child_ptask->bundle.id,
+                         child_ptask->bundle.is_executeOn);
 
-    // begin critical section
-    chpl_thread_mutexLock(&extra_task_lock);
+  if (do_taskReport) {
+    chpl_thread_mutexLock(&taskTable_lock);
+    chpldev_taskTable_set_active(curr_ptask->bundle.id);
+    chpldev_taskTable_remove(child_ptask->bundle.id);
+    chpl_thread_mutexUnlock(&taskTable_lock);
+  }
 
-    extra_task_cnt--;
+  // begin critical section
+  chpl_thread_mutexLock(&extra_task_lock);
 
-    // end critical section
-    chpl_thread_mutexUnlock(&extra_task_lock);
+  extra_task_cnt--;
 
-    set_current_ptask(curr_ptask);
-    chpl_mem_free(child_ptask, 0, 0);
+  // end critical section
+  chpl_thread_mutexUnlock(&extra_task_lock);
 
-  }
+  set_current_ptask(curr_ptask);
+  chpl_mem_free(child_ptask, 0, 0);
 }
 
 
@@ -718,14 +1122,16 @@ void taskCallBody(chpl_fn_int_t fid, chpl_fn_p fp,
                   chpl_task_bundle_t* arg, size_t arg_size,
                   c_sublocid_t subloc,
                   int lineno, int32_t filename) {
-  // begin critical section
-  chpl_thread_mutexLock(&threading_lock);
+  // begin critical section (the work-stealing pool doesn't need one)
+  if (!work_stealing)
+    chpl_thread_mutexLock(&threading_lock);
 
   (void) add_to_task_pool(fid, fp, arg, arg_size, true,
                           NULL, false, lineno, filename);
 
   // end critical section
-  chpl_thread_mutexUnlock(&threading_lock);
+  if (!work_stealing)
+    chpl_thread_mutexUnlock(&threading_lock);
 }
 
 
@@ -847,7 +1253,7 @@ size_t chpl_task_getCallStackSize(void) {
 }
 
 uint32_t chpl_task_getNumQueuedTasks(void) {
-  return queued_task_cnt;
+  return atomic_load_int_least32_t(&queued_task_cnt);
 }
 
 int32_t chpl_task_getNumBlockedTasks(void) {
@@ -858,7 +1264,8 @@ int32_t chpl_task_getNumBlockedTasks(void) {
     chpl_thread_mutexLock(&threading_lock);
     chpl_thread_mutexLock(&block_report_lock);
 
-    numBlockedTasks = blocked_thread_cnt - idle_thread_cnt;
+    numBlockedTasks = blocked_thread_cnt
+                      - atomic_load_int_least32_t(&idle_thread_cnt);
 
     // end critical section
     chpl_thread_mutexUnlock(&block_report_lock);
@@ -878,15 +1285,9 @@ int32_t chpl_task_getNumBlockedTasks(void) {
 // Get a new task ID.
 //
 static chpl_taskID_t get_next_task_id(void) {
-  static chpl_taskID_t       id = chpl_nullTaskID + 1;
+  static atomic_uint_least64_t id = chpl_nullTaskID + 1;
 
-  chpl_taskID_t              next_id;
-
-  chpl_thread_mutexLock(&task_id_lock);
-  next_id = id++;
-  chpl_thread_mutexUnlock(&task_id_lock);
-
-  return next_id;
+  return (chpl_taskID_t) atomic_fetch_add_uint_least64_t(&id, 1);
 }
 
 
@@ -964,6 +1365,27 @@ static void report_all_tasks(void) {
            pendingTask->bundle.lineno);
     pendingTask = pendingTask->next;
   }
+  if (work_stealing) {
+    int32_t num_deques = atomic_load_int_least32_t(&ws_num_deques);
+    if (num_deques > WS_MAX_DEQUES)
+      num_deques = WS_MAX_DEQUES;
+    for (int32_t i = 0; i < num_deques; i++) {
+      ws_deque_t* d = (ws_deque_t*) atomic_load_uintptr_t(&ws_deques[i]);
+      ws_array_t* a;
+      int64_t b;
+      if (d == NULL)
+        continue;
+      a = (ws_array_t*) atomic_load_uintptr_t(&d->array);
+      b = atomic_load_int_least64_t(&d->bottom);
+      for (int64_t t = atomic_load_int_least64_t(&d->top); t < b; t++) {
+        pendingTask =
+          (task_pool_p) atomic_load_uintptr_t(&a->slots[t & (a->size - 1)]);
+        printf("- %s:%d\n",
+               chpl_lookupFilename(pendingTask->bundle.filename),
+               pendingTask->bundle.lineno);
+      }
+    }
+  }
   printf("\n");
 
   // print out running tasks
@@ -1125,6 +1547,8 @@ thread_begin(void* ptask_void) {
 
   tp->ptask = NULL;
   tp->lockRprt = NULL;
+  tp->deque = work_stealing ? ws_new_deque() : NULL;
+  tp->steal_seed = (uint32_t) (intptr_t) tp | 1;
   if (blockreport)
     initializeLockReportForThread();
 
@@ -1143,7 +1567,7 @@ thread_begin(void* ptask_void) {
     // that were waiting on the signal, but since there was a performance
     // impact from keeping it as a hybrid as opposed to merely yielding,
     // it was decided that we would return to the simple yield case.
-    while (!task_pool_head) {
+    while (task_pool_is_empty()) {
       if (set_block_loc(0, CHPL_FILE_IDX_IDLE_TASK)) {
         // all other tasks appear to be blocked
         struct timeval deadline, now;
@@ -1151,54 +1575,69 @@ thread_begin(void* ptask_void) {
         deadline.tv_sec += 1;
         do {
           chpl_thread_yield();
-          if (!task_pool_head)
+          if (task_pool_is_empty())
             gettimeofday(&now, NULL);
-        } while (!task_pool_head
+        } while (task_pool_is_empty()
                  && (now.tv_sec < deadline.tv_sec
                      || (now.tv_sec == deadline.tv_sec
                          && now.tv_usec < deadline.tv_usec)));
-        if (!task_pool_head) {
+        if (task_pool_is_empty()) {
           check_for_deadlock();
         }
       }
       else {
         do {
           chpl_thread_yield();
-        } while (!task_pool_head);
+        } while (task_pool_is_empty());
       }
 
       unset_block_loc();
     }
- 
-    //
-    // Just now the pool had at least one task in it.  Lock and see if
-    // there's something still there.
-    //
-    chpl_thread_mutexLock(&threading_lock);
-    if (!task_pool_head) {
-      chpl_thread_mutexUnlock(&threading_lock);
-      continue;
+
+    if (work_stealing) {
+      //
+      // Just now some deque or the injection queue had a task in it.
+      // Try to get one.
+      //
+      if ((ptask = ws_take_task(tp)) == NULL)
+        continue;
+
+      if (blockreport)
+        progress_cnt++;
+
+      (void) atomic_fetch_sub_int_least32_t(&idle_thread_cnt, 1);
     }
+    else {
+      //
+      // Just now the pool had at least one task in it.  Lock and see if
+      // there's something still there.
+      //
+      chpl_thread_mutexLock(&threading_lock);
+      if (!task_pool_head) {
+        chpl_thread_mutexUnlock(&threading_lock);
+        continue;
+      }
 
-    //
-    // We've found a task to run.
-    //
+      //
+      // We've found a task to run.
+      //
 
-    if (blockreport)
-      progress_cnt++;
+      if (blockreport)
+        progress_cnt++;
 
-    //
-    // start new task; remove task from pool also add to task to task-table
-    // (structure in ChapelRuntime that keeps track of currently running tasks
-    // for task-reports on deadlock or Ctrl+C).
-    //
-    ptask = task_pool_head;
-    idle_thread_cnt--;
+      //
+      // start new task; remove task from pool also add to task to
+      // task-table (structure in ChapelRuntime that keeps track of
+      // currently running tasks for task-reports on deadlock or Ctrl+C).
+      //
+      ptask = task_pool_head;
+      (void) atomic_fetch_sub_int_least32_t(&idle_thread_cnt, 1);
 
-    dequeue_task(ptask);
+      dequeue_task(ptask);
 
-    // end critical section
-    chpl_thread_mutexUnlock(&threading_lock);
+      // end critical section
+      chpl_thread_mutexUnlock(&threading_lock);
+    }
 
     tp->ptask = ptask;
 
@@ -1233,16 +1672,10 @@ thread_begin(void* ptask_void) {
     tp->ptask = NULL;
     chpl_mem_free(ptask, 0, 0);
 
-    // begin critical section
-    chpl_thread_mutexLock(&threading_lock);
-
     //
     // finished task; increment idle count
     //
-    idle_thread_cnt++;
-
-    // end critical section
-    chpl_thread_mutexUnlock(&threading_lock);
+    (void) atomic_fetch_add_int_least32_t(&idle_thread_cnt, 1);
   }
 }
 
@@ -1274,7 +1707,7 @@ static void maybe_add_thread(void) {
 
   if (!warning_issued && chpl_thread_canCreate()) {
     if (chpl_thread_create(NULL) == 0) {
-      idle_thread_cnt++;
+      (void) atomic_fetch_add_int_least32_t(&idle_thread_cnt, 1);
     }
     else {
       int32_t max_threads = chpl_thread_getMaxThreads();
@@ -1299,7 +1732,8 @@ static void maybe_add_thread(void) {
 
 // create a task from the given function pointer and arguments
 // and append it to the end of the task pool
-// assumes threading_lock has already been acquired!
+// assumes threading_lock has already been acquired, unless we're
+// using the work-stealing pool!
 static inline
 task_pool_p add_to_task_pool(chpl_fn_int_t fid, chpl_fn_p fp,
                              chpl_task_bundle_t* a, size_t a_size,
@@ -1338,7 +1772,12 @@ task_pool_p add_to_task_pool(chpl_fn_int_t fid, chpl_fn_p fp,
   ptask->bundle.requested_fn    = fp;
   ptask->bundle.id              = get_next_task_id();
 
-  enqueue_task(ptask, p_task_list_head);
+  //
+  // Without the lock, another thread could start the task as soon as
+  // it's in the pool, so in that case announce it first.
+  //
+  if (!work_stealing)
+    enqueue_task(ptask, p_task_list_head);
 
   chpl_task_do_callbacks(chpl_task_cb_event_kind_create,
                          ptask->bundle.requested_fid,
@@ -1355,10 +1794,21 @@ task_pool_p add_to_task_pool(chpl_fn_int_t fid, chpl_fn_p fp,
     chpl_thread_mutexUnlock(&taskTable_lock);
   }
 
+  if (work_stealing)
+    ws_enqueue_task(ptask, p_task_list_head);
+
   // If we now have more tasks than threads to run them on, try to start
   // another thread
-  if (queued_task_cnt > idle_thread_cnt) {
-    maybe_add_thread();
+  if (atomic_load_int_least32_t(&queued_task_cnt)
+      > atomic_load_int_least32_t(&idle_thread_cnt)) {
+    if (work_stealing) {
+      chpl_thread_mutexLock(&threading_lock);
+      maybe_add_thread();
+      chpl_thread_mutexUnlock(&threading_lock);
+    }
+    else {
+      maybe_add_thread();
+    }
   }
 
   return ptask;
@@ -1372,5 +1822,5 @@ uint32_t chpl_task_getNumThreads(void) {
 }
 
 uint32_t chpl_task_getNumIdleThreads(void) {
-  return idle_thread_cnt;
+  return atomic_load_int_least32_t(&idle_thread_cnt);
 }
@@ -126,6 +126,8 @@ static void profile_print(void)
 // effect of its (very portable) memory fence.
 //
 volatile int chpl_qthread_done_initializing;
+
+int chpl_qthread_cache_task_migration = 0;
 static aligned_t canexit = 0;
 static pthread_mutex_t init_mutex = PTHREAD_MUTEX_INITIALIZER;
 
@@ -178,12 +180,25 @@ chpl_qthread_tls_t chpl_qthread_comm_task_tls = {
 
 static aligned_t exit_ret = 0;
 
+//
+// Called before anything that might suspend the running task.  With a
+// scheduler that can resume it on a different worker (pthread), tell
+// the remote data cache if it is in use.
+//
+static inline void before_task_may_move(void)
+{
+    if (chpl_qthread_cache_task_migration) {
+        chpl_task_beforeMigration();
+    }
+}
+
 void chpl_task_yield(void)
 {
     PROFILE_INCR(profile_task_yield,1);
     if (qthread_shep() == NO_SHEPHERD) {
         sched_yield();
     } else {
+        before_task_may_move();
         qthread_yield();
     }
 }
@@ -193,6 +208,7 @@ void chpl_sync_lock(chpl_sync_aux_t *s)
 {
     PROFILE_INCR(profile_sync_lock, 1);
 
+    before_task_may_move();
     qthread_lock(&s->lock);
 }
 
@@ -212,6 +228,7 @@ void chpl_sync_waitFullAndLock(chpl_sync_aux_t *s,
     chpl_sync_lock(s);
     while (s->is_full == 0) {
         chpl_sync_unlock(s);
+        before_task_may_move();
         qthread_readFE(NULL, &(s->signal_full));
         chpl_sync_lock(s);
     }
@@ -226,6 +243,7 @@ void chpl_sync_waitEmptyAndLock(chpl_sync_aux_t *s,
     chpl_sync_lock(s);
     while (s->is_full != 0) {
         chpl_sync_unlock(s);
+        before_task_may_move();
         qthread_readFE(NULL, &(s->signal_empty));
         chpl_sync_lock(s);
     }
@@ -628,6 +646,17 @@ static void setupWorkStealing(void) {
     // that not all schedulers support work stealing, but it doesn't hurt to
     // set this env var for those configs anyways.
     chpl_qt_setenv("STEAL_RATIO", "0", 0);
+
+    // Schedulers that can move tasks between workers (stealing, or
+    // several workers sharing a shepherd's queue) can't use the remote
+    // data cache unless we tell it whenever a task might move.  That
+    // costs a cache release at each potential suspension, so only do it
+    // if asked.  The other schedulers never move tasks, so there is
+    // nothing to do for them.
+    if (!CHPL_QTHREAD_SUPPORTS_REMOTE_CACHE) {
+        chpl_qthread_cache_task_migration =
+            chpl_env_rt_get_bool("CACHE_TASK_MIGRATION", false);
+    }
 }
 
 static void setupSpinWaiting(void) {
@@ -0,0 +1,6 @@
+// Reports a few of the settings the compiler got from printchplenv, or
+// from the --chplenv-cache copy of its output, and stops.
+use ChapelEnv;
+
+compilerError("CHPL_TASKS=" + CHPL_TASKS +
+              " CHPL_AUX_FILESYS=" + CHPL_AUX_FILESYS);
@@ -0,0 +1,43 @@
+// Exercise globals, classes, and dynamic dispatch across the
+// C files generated with --c-partitions.
+config const n = 10;
+
+var total: int;
+
+class Shape {
+  proc area(): real { return 0.0; }
+}
+
+class Square : Shape {
+  var side: real;
+  override proc area(): real { return side * side; }
+}
+
+class Circle : Shape {
+  var r: real;
+  override proc area(): real { return 3.0 * r * r; }
+}
+
+proc addUp(shapes) {
+  var sum = 0.0;
+  for s in shapes do
+    sum += s.area();
+  return sum;
+}
+
+var shapes: [1..n] unmanaged Shape;
+for i in 1..n {
+  if i % 2 == 0 then
+    shapes[i] = new unmanaged Square(i);
+  else
+    shapes[i] = new unmanaged Circle(i);
+}
+
+forall i in 1..n with (+ reduce total) do
+  total += i;
+
+writeln(total);
+writeln(addUp(shapes));
+
+for s in shapes do
+  delete s;
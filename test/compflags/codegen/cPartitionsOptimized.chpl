@@ -0,0 +1,4 @@
+var x = 1;
+var y = 2;
+writeln("Computing...");
+writeln(x*y);
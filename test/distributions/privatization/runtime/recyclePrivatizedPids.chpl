@@ -0,0 +1,35 @@
+use PrivatizationWrappers;
+
+extern proc chpl_newPrivatizedPid(): int;
+
+var pids: [1..10] int;
+for p in pids {
+  p = chpl_newPrivatizedPid();
+  insertPrivatized(new unmanaged C(p), p);
+}
+
+// free two pids, one of them twice
+for i in [3, 7, 7] {
+  var c = getPrivatized(pids[i]);
+  delete c;
+  clearPrivatized(pids[i]);
+}
+
+// they should be handed out again, most recently freed first, and only once
+const r1 = chpl_newPrivatizedPid(),
+      r2 = chpl_newPrivatizedPid(),
+      r3 = chpl_newPrivatizedPid();
+writeln(r1 == pids[7]);
+writeln(r2 == pids[3]);
+writeln(r3 > max reduce pids);
+
+// no leaks
+pids[3] = r2; pids[7] = r1;
+insertPrivatized(new unmanaged C(r1), r1);
+insertPrivatized(new unmanaged C(r2), r2);
+for p in pids {
+  assert(getPrivatized(p).i == p);
+  var c = getPrivatized(p);
+  delete c;
+  clearPrivatized(p);
+}
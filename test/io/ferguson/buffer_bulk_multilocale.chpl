@@ -0,0 +1,60 @@
+use Buffers;
+
+// Copy buffers made of many large parts, and large bytes, between
+// locales, and check the data at regular intervals.
+
+config const numParts = 12;
+config const stride = 1000;  // in int(32)s
+
+proc partLen(i:int) return ((i * 123457) % 1500000 + 3) * 4;
+
+proc main() {
+  var buf = new buffer();
+  var total = 0;
+  for i in 1..numParts {
+    buf.append(new bytes(partLen(i)));
+    total += partLen(i);
+  }
+
+  // write the index of every stride'th int(32)
+  var it = buf.start();
+  for j in 0..#(total / 4) by stride {
+    var v = j:int(32);
+    it = buf.copyin(it, v);
+    buf.advance(it, stride * 4 - 4);
+  }
+
+  const flat = buf.flatten(buf.all());
+
+  proc check(b:buffer, name:string) {
+    var it = b.start();
+    var ok = true;
+    for j in 0..#(total / 4) by stride {
+      var v:int(32);
+      it = b.copyout(it, v);
+      if v != j then ok = false;
+      b.advance(it, stride * 4 - 4);
+    }
+    writeln(name, ": ", ok);
+  }
+
+  on Locales[1] {
+    // flatten a remote buffer with many parts
+    var b1 = new buffer();
+    b1.append(buf.flatten(buf.all()));
+    check(b1, "flatten");
+
+    // copy a remote buffer
+    var b2 = new buffer();
+    b2 = buf;
+    check(b2, "buffer copy");
+
+    // copy remote bytes
+    var lb = new bytes();
+    lb = flat;
+    var b3 = new buffer();
+    b3.append(lb);
+    check(b3, "bytes copy");
+    writeln(lb.len == total);
+  }
+}
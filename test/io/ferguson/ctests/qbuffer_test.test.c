@@ -31,6 +31,53 @@ void test_qbytes(void)
   qbytes_release(b);
 }
 
+void test_iobuf_pool(void)
+{
+  qbytes_t* b[100];
+  qbytes_iobuf_pool_stats_t before, after;
+  qioerr err;
+  int i, j;
+
+  qbytes_iobuf_pool_stats(&before);
+
+  // released iobufs are reused, and come back zeroed
+  err = qbytes_create_iobuf(&b[0]);
+  assert(!err);
+  memset(b[0]->data, 0xff, b[0]->len);
+  qbytes_release(b[0]);
+
+  err = qbytes_create_iobuf(&b[0]);
+  assert(!err);
+  for( j = 0; j < b[0]->len; j++ ) assert( ((unsigned char*) b[0]->data)[j] == 0 );
+  qbytes_release(b[0]);
+
+  qbytes_iobuf_pool_stats(&after);
+  assert( after.allocs - before.allocs == 2 );
+  assert( after.hits - before.hits >= 1 );
+
+  // releasing more than the high watermark trims to the low watermark
+  for( i = 0; i < 100; i++ ) {
+    err = qbytes_create_iobuf(&b[i]);
+    assert(!err);
+  }
+  for( i = 0; i < 100; i++ ) qbytes_release(b[i]);
+
+  qbytes_iobuf_pool_stats(&after);
+  assert( after.pooled >= qbytes_iobuf_pool_low );
+  assert( after.pooled <= qbytes_iobuf_pool_high );
+  assert( after.trimmed > before.trimmed );
+
+  qbytes_iobuf_pool_exit();
+
+  qbytes_iobuf_pool_stats(&after);
+  assert( after.pooled == 0 );
+
+  // after exit, iobufs still work but aren't pooled
+  err = qbytes_create_iobuf(&b[0]);
+  assert(!err);
+  qbytes_release(b[0]);
+}
+
 void test_qbuffer_iterators(qbuffer_t* buf, qbytes_t** qb, int num, int skip, int trunc)
 {
   qbuffer_iter_t cur;
@@ -560,6 +607,8 @@ int main(int argc, char** argv)
 
   test_qbuffer_edges();
 
+  test_iobuf_pool();
+
   printf("qbuffer_test PASS\n");
 
   return 0;
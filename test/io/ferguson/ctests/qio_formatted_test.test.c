@@ -1080,11 +1080,71 @@ void basicstring_test()
 }
 
 
+// Read NUL-terminated strings where the last one has no terminator.
+void missing_terminator_test()
+{
+	const char data[] = "abc\0defgh";
+	const char *out = NULL;
+	qioerr err;
+	qio_file_t *f = NULL;
+	qio_channel_t *reading = NULL;
+	qio_channel_t *writing = NULL;
+	qio_style_t style = qio_style_default();
+	int64_t out_len = 0;
+	int64_t offset = 0;
+	ssize_t amt = 0;
+	char rest[8];
+
+	style.binary = 1;
+	style.str_style = QIO_STRSTYLE_NULL_TERMINATED;
+
+	err = qio_file_open_tmp(&f, 0, NULL);
+	assert(!err);
+
+	err = qio_channel_create(&writing, f, QIO_CH_BUFFERED, 0, 1, 0, INT64_MAX, &style);
+	assert(!err);
+	// write everything but the trailing NUL from the string literal
+	err = qio_channel_write_amt(true, writing, data, sizeof(data) - 1);
+	assert(!err);
+	qio_channel_release(writing);
+
+	err = qio_channel_create(&reading, f, QIO_CH_BUFFERED, 1, 0, 0, INT64_MAX, &style);
+	assert(!err);
+
+	err = qio_channel_read_string(true, style.byteorder, style.str_style, reading, &out, &out_len, -1);
+	assert(!err);
+	assert(out_len == 3);
+	assert(0 == strcmp(out, "abc"));
+	qio_free((void*) out); out = NULL;
+
+	// "defgh" runs into EOF without a terminator
+	err = qio_channel_read_string(true, style.byteorder, style.str_style, reading, &out, &out_len, -1);
+	assert(qio_err_to_int(err) == EEOF);
+	assert(out == NULL);
+
+	// and nothing was consumed
+	err = qio_channel_offset(true, reading, &offset);
+	assert(!err);
+	assert(offset == 4);
+
+	err = qio_channel_read(true, reading, rest, sizeof(rest), &amt);
+	assert(qio_err_to_int(err) == EEOF);
+	assert(amt == 5);
+	assert(0 == memcmp(rest, "defgh", 5));
+
+	qio_channel_release(reading);
+	qio_file_release(f);
+
+	if( verbose ) printf("PASS: missing string terminator\n");
+}
+
 void test_readwritestring()
 {
 	//basicstring_test(); in main.
 	write_65k_test();   //write 65k then read it back.
 
+	missing_terminator_test();
+
 	//min_width_test();  //test min_width              
 	//max_width_test();  //test max_width
 	
@@ -1492,6 +1552,69 @@ void test_quoted_string_maxlength(void)
   if( verbose ) printf("PASS: quoted max length\n");
 }
 
+void test_conv_plan(void)
+{
+  const char* fmts[] = {"%i %r\n", "%{##.###} and %s", "x%/a+/y %i",
+                        "%<ixx", "%5.2r %-10s %'S", "no conversions", NULL};
+  char buf[64];
+
+  for( int scanning = 0; scanning < 2; scanning++ ) {
+    for( int f = 0; fmts[f]; f++ ) {
+      size_t len = strlen(fmts[f]);
+      qio_conv_plan_t* plan;
+      size_t cur = 0;
+
+      // The plan is found by the contents of the format string,
+      // not by where it is.
+      strcpy(buf, fmts[f]);
+      plan = qio_conv_plan_get(buf, len, scanning);
+      assert(plan);
+      assert(plan == qio_conv_plan_get(fmts[f], len, scanning));
+      assert(plan != qio_conv_plan_get(fmts[f], len, !scanning));
+      memset(buf, 'z', len);
+      assert(plan != qio_conv_plan_get(buf, len, scanning));
+
+      // Replaying the plan gives the same results as parsing.
+      while( cur < len ) {
+        qio_conv_t spec, got_spec;
+        qio_style_t style, got_style;
+        uint64_t end, got_end;
+        qioerr err, got_err;
+
+        err = qio_conv_parse(fmts[f], cur, &end, scanning, &spec, &style);
+        got_err = qio_conv_plan_parse(plan, fmts[f], cur, &got_end, scanning,
+                                      &got_spec, &got_style);
+        assert(qio_err_to_int(err) == qio_err_to_int(got_err));
+        if( err ) break;
+        assert(end == got_end);
+        assert(spec.argType == got_spec.argType);
+        assert(spec.preArg1 == got_spec.preArg1);
+        assert(spec.preArg2 == got_spec.preArg2);
+        assert(spec.preArg3 == got_spec.preArg3);
+        assert(spec.literal_length == got_spec.literal_length);
+        assert(0 == memcmp(spec.literal, got_spec.literal,
+                           spec.literal_length));
+        assert(spec.regexp_length == got_spec.regexp_length);
+        assert(0 == memcmp(spec.regexp, got_spec.regexp,
+                           spec.regexp_length));
+        assert(0 == memcmp(&style, &got_style, sizeof(style)));
+        cur = end;
+      }
+    }
+  }
+
+  // Without a plan, it just parses.
+  {
+    qio_conv_t spec;
+    qio_style_t style;
+    uint64_t end;
+    qioerr err = qio_conv_plan_parse(NULL, "%i", 0, &end, 0, &spec, &style);
+    assert(!err);
+    assert(end == 2);
+    assert(spec.argType == QIO_CONV_ARG_TYPE_SIGNED);
+  }
+}
+
 int main(int argc, char** argv)
 {
   int sizes[] = {qbytes_iobuf_size, 64, 1, 2, 0};
@@ -1503,6 +1626,8 @@ int main(int argc, char** argv)
     printf("Sizeof of qio_channel_t is %i\n", (int) sizeof(qio_channel_t));
   }
 
+  test_conv_plan();
+
   for( int i = 0; sizes[i] != 0; i++ ) {
     char* codeset = nl_langinfo(CODESET); 
     qbytes_iobuf_size = sizes[i];
@@ -0,0 +1,215 @@
+#include "qio.h"
+#include <assert.h>
+#include <stdio.h>
+
+// Checks how QIO_METHOD_MMAP reading channels share the file's list of
+// mapped windows, how the list drops its least recently used window,
+// how a channel's window grows while it streams, and that windows are
+// unmapped once no channel is using them.
+
+int verbose = 0;
+
+#define FILE_LEN (1024*1024)
+#define REGION (64*1024)
+
+unsigned char data_at(int64_t offset)
+{
+  return offset + (offset >> 2) + 'a' + (offset % 7);
+}
+
+int num_windows(qio_file_t* f)
+{
+  int i;
+  for( i = 0; i < QIO_MMAP_WINDOWS && f->mmap_windows[i].bytes; i++ ) ;
+  return i;
+}
+
+int find_window(qio_file_t* f, int64_t start)
+{
+  int i;
+  for( i = 0; i < QIO_MMAP_WINDOWS && f->mmap_windows[i].bytes; i++ ) {
+    if( f->mmap_windows[i].start == start ) return i;
+  }
+  return -1;
+}
+
+qio_file_t* make_file(void)
+{
+  qio_file_t* f;
+  qio_channel_t* writing;
+  unsigned char* data;
+  int64_t k;
+  qioerr err;
+
+  data = malloc(FILE_LEN);
+  assert(data);
+  for( k = 0; k < FILE_LEN; k++ ) data[k] = data_at(k);
+
+  err = qio_file_open_tmp(&f, QIO_METHOD_MMAP, NULL);
+  assert(!err);
+
+  err = qio_channel_create(&writing, f, QIO_METHOD_PREADPWRITE, 0, 1, 0, INT64_MAX, NULL);
+  assert(!err);
+  err = qio_channel_write_amt(true, writing, data, FILE_LEN);
+  assert(!err);
+  qio_channel_release(writing);
+
+  free(data);
+  return f;
+}
+
+// Read amt bytes at start with a new channel, check them, and return
+// the channel, still open.
+qio_channel_t* read_at(qio_file_t* f, int64_t start, int64_t amt)
+{
+  qio_channel_t* ch;
+  unsigned char buf[1024];
+  int64_t k;
+  ssize_t got;
+  qioerr err;
+
+  assert(amt <= sizeof(buf));
+
+  err = qio_channel_create(&ch, f, QIO_CH_ALWAYS_BUFFERED | QIO_METHOD_MMAP, 1, 0, start, INT64_MAX, NULL);
+  assert(!err);
+  err = qio_channel_read(true, ch, buf, amt, &got);
+  assert(!err);
+  assert(got == amt);
+  for( k = 0; k < amt; k++ ) assert(buf[k] == data_at(start + k));
+
+  return ch;
+}
+
+void test_sharing(void)
+{
+  qio_file_t* f = make_file();
+  qio_channel_t* a;
+  qio_channel_t* b;
+  qbytes_t* w;
+
+  a = read_at(f, 100, 500);
+  assert(num_windows(f) == 1);
+  w = f->mmap_windows[0].bytes;
+
+  // An overlapping read reuses a's window instead of mapping again.
+  b = read_at(f, 300, 500);
+  assert(num_windows(f) == 1);
+  assert(f->mmap_windows[0].bytes == w);
+
+  // A disjoint one gets its own, at the front of the list.
+  qio_channel_release(b);
+  b = read_at(f, 5 * REGION, 10);
+  assert(num_windows(f) == 2);
+  assert(f->mmap_windows[0].start == 5 * REGION);
+  assert(f->mmap_windows[1].bytes == w);
+
+  qio_channel_release(a);
+  qio_channel_release(b);
+  assert(num_windows(f) == 0);
+  qio_file_release(f);
+
+  if( verbose ) printf("PASS: window sharing\n");
+}
+
+void test_lru(void)
+{
+  qio_file_t* f = make_file();
+  qio_channel_t* chs[QIO_MMAP_WINDOWS + 2];
+  qio_channel_t* again;
+  int i;
+
+  // Map one more window than the list holds.
+  for( i = 0; i < QIO_MMAP_WINDOWS + 1; i++ ) {
+    chs[i] = read_at(f, i * REGION, 10);
+  }
+  assert(num_windows(f) == QIO_MMAP_WINDOWS);
+  assert(find_window(f, 0) == -1);
+  assert(find_window(f, QIO_MMAP_WINDOWS * REGION) == 0);
+  assert(find_window(f, 1 * REGION) == QIO_MMAP_WINDOWS - 1);
+
+  // Using a window moves it to the front, so it's no longer next out.
+  again = read_at(f, 1 * REGION + 5, 5);
+  assert(find_window(f, 1 * REGION) == 0);
+  chs[QIO_MMAP_WINDOWS + 1] = read_at(f, (QIO_MMAP_WINDOWS + 1) * REGION, 10);
+  assert(num_windows(f) == QIO_MMAP_WINDOWS);
+  assert(find_window(f, 1 * REGION) == 1);
+  assert(find_window(f, 2 * REGION) == -1);
+
+  // Closing a channel keeps a window another channel is still using,
+  // and drops the ones nobody is.
+  qio_channel_release(chs[1]);
+  assert(find_window(f, 1 * REGION) != -1);
+  qio_channel_release(again);
+  assert(find_window(f, 1 * REGION) == -1);
+  assert(num_windows(f) == QIO_MMAP_WINDOWS - 1);
+
+  for( i = 0; i < QIO_MMAP_WINDOWS + 2; i++ ) {
+    if( i != 1 ) qio_channel_release(chs[i]);
+  }
+  assert(num_windows(f) == 0);
+  qio_file_release(f);
+
+  if( verbose ) printf("PASS: LRU eviction\n");
+}
+
+void test_growth(void)
+{
+  qio_file_t* f = make_file();
+  qio_channel_t* ch;
+  int64_t min_window = qio_mmap_min_chunk_iobufs * qbytes_iobuf_size;
+  int64_t max_window = qio_mmap_chunk_iobufs * qbytes_iobuf_size;
+  int64_t last = 0;
+  int64_t offset = 0;
+  int grew = 0;
+  unsigned char c;
+  qioerr err;
+
+  // A channel streaming through the file doubles its window each time
+  // it needs a new one, up to the maximum.
+  err = qio_channel_create(&ch, f, QIO_CH_ALWAYS_BUFFERED | QIO_METHOD_MMAP, 1, 0, 0, INT64_MAX, NULL);
+  assert(!err);
+  while( offset < 4 * max_window ) {
+    err = qio_channel_read_amt(true, ch, &c, 1);
+    assert(!err);
+    assert(c == data_at(offset));
+    offset++;
+    if( ch->mmap_window != last ) {
+      if( last == 0 ) assert(ch->mmap_window == min_window);
+      else assert(ch->mmap_window == 2 * last);
+      last = ch->mmap_window;
+      grew++;
+    }
+  }
+  assert(last == max_window);
+  assert(grew > 2);
+  qio_channel_release(ch);
+
+  // A channel that starts in the middle of the file, away from where
+  // its previous window ended, starts small.
+  ch = read_at(f, 3 * REGION + 7, 10);
+  assert(ch->mmap_window == min_window);
+  qio_channel_release(ch);
+
+  assert(num_windows(f) == 0);
+  qio_file_release(f);
+
+  if( verbose ) printf("PASS: window growth\n");
+}
+
+int main(int argc, char** argv)
+{
+  if( argc != 1 ) verbose = 1;
+
+  // use small windows for testing.
+  qbytes_iobuf_size = 4*1024;
+  qio_mmap_min_chunk_iobufs = 1;
+  qio_mmap_chunk_iobufs = 8;
+
+  test_sharing();
+  test_lru();
+  test_growth();
+
+  printf("qio_mmap_windows_test PASS\n");
+
+  return 0;
+}
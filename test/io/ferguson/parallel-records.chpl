@@ -0,0 +1,76 @@
+use IO, FileSystem;
+
+config const n = 200000;
+config const path = "parallel-records.txt";
+
+// Write n records of varying length, separated by sep, and check that
+// iterating over them in parallel finds each one exactly once.
+proc check(sep:string, trailing:bool, region:bool) {
+  var f = open(path, iomode.cwr);
+  {
+    var w = f.writer();
+    for i in 1..n {
+      w.write(i, ":", "x" * (i % 17));
+      if i < n || trailing then w.write(sep);
+    }
+    w.close();
+  }
+
+  const sepByte = ascii(sep);
+  var start = 0, end = max(int);
+  if region {
+    // Cover just the middle of the file, starting and ending on records.
+    proc nextRecord(off:int) {
+      var r = f.reader(start=off);
+      r.advancePastByte(sepByte);
+      const ret = r.offset();
+      r.close();
+      return ret;
+    }
+    start = nextRecord(1000);
+    end = nextRecord(f.length() / 2);
+  }
+
+  var serialCount, serialSum, serialBytes: int;
+  for rec in f.records(sepByte, start, end) {
+    serialCount += 1;
+    serialBytes += rec.length;
+    serialSum += rec[1..rec.find(":")-1]:int;
+  }
+
+  var count, sum, bytes: int;
+  forall rec in f.records(sepByte, start, end)
+      with (+ reduce count, + reduce sum, + reduce bytes) {
+    count += 1;
+    bytes += rec.length;
+    sum += rec[1..rec.find(":")-1]:int;
+  }
+
+  writeln(sep == "\n", " ", trailing, " ", region, ": ",
+          count == serialCount, " ", sum == serialSum, " ",
+          bytes == serialBytes,
+          if region then "" else " " + (bytes == f.length()):string);
+  f.close();
+}
+
+for sep in ["\n", ";"] do
+  for trailing in [true, false] do
+    for region in [false, true] do
+      check(sep, trailing, region);
+
+// forall over file.lines() is parallel too
+{
+  var f = open(path, iomode.cwr);
+  {
+    var w = f.writer();
+    for i in 1..n do w.writeln(i);
+    w.close();
+  }
+  var sum: int;
+  forall line in f.lines() with (+ reduce sum) do
+    sum += line.strip():int;
+  writeln(sum == n * (n + 1) / 2);
+  f.close();
+}
+
+remove(path);
@@ -0,0 +1,56 @@
+// Read numbers in a variety of formats, including ones that
+// fall back from the fast path to the general one.
+use IO, Random;
+
+config const n = 100000;
+
+const ints = "0 -0 7 -12 00012 9223372036854775807 -9223372036854775807 " +
+             "123456789012345678 12x 42\n";
+const reals = "0 -0 1 -1.5 5. 1e5 1E5 1e+5 2.5e-3 0.000123 00012.50 " +
+              "9007199254740993 1.7976931348623157e308 " +
+              "2.2250738585072014e-308 4.9406564584124654e-324 " +
+              "0.1 0.30000000000000004 123456789.123456789 " +
+              "1.00000000000000000000001 inf -nan 12,34\n";
+
+{
+  var f = openmem();
+  f.writer().write(ints);
+  var r = f.reader();
+  for 1..9 {
+    var x: int;
+    r.read(x);
+    writeln(x);
+  }
+}
+
+{
+  var f = openmem();
+  f.writer().write(reals);
+  var r = f.reader();
+  for 1..22 {
+    var x: real;
+    r.read(x);
+    writef("%.17er\n", x);
+  }
+}
+
+// Reals should survive a round trip through text.
+{
+  var f = openmem();
+  var w = f.writer();
+  var rs = new owned RandomStream(real, seed=314159);
+  var xs: [1..n] real;
+  for (x, i) in zip(xs, 1..) {
+    x = (rs.getNext() - 0.5) * 10.0 ** ((i % 600) - 300);
+    w.writef("%.17er ", x);
+  }
+  w.close();
+  var r = f.reader();
+  var bad = 0;
+  for x in xs {
+    var y: real;
+    r.read(y);
+    if x != y then bad += 1;
+  }
+  writeln("round trip mismatches: ", bad);
+}
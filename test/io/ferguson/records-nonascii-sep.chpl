@@ -0,0 +1,12 @@
+use IO;
+
+// A separator that could be part of a multibyte character is rejected.
+var f = opentmp();
+{
+  var w = f.writer();
+  w.write("aébéc");
+  w.close();
+}
+
+forall rec in f.records(sep=0xa9) do
+  writeln(rec);
@@ -0,0 +1,56 @@
+use IO;
+
+config const numTasks = 8;
+config const n = 10000;
+
+// Have several tasks write to one channel at once.  Channel locks are
+// biased toward the first task to use them, so this checks that taking
+// the bias away from that task, while it holds the lock, still keeps
+// the other tasks out.
+var f = openmem();
+{
+  var w = f.writer();
+  var done$: sync bool;
+
+  w.lock();
+  w.write(0, " ");
+  begin {
+    coforall t in 1..numTasks {
+      for i in 1..n {
+        if i % 2 == 0 {
+          w.writeln(t, " ", i);
+        } else {
+          // hold the lock across two writes
+          w.lock();
+          w.write(t, " ");
+          w.writeln(i);
+          w.unlock();
+        }
+      }
+    }
+    done$ = true;
+  }
+  w.writeln(0);
+  w.unlock();
+  done$;
+  w.close();
+}
+
+var seen: [1..numTasks, 1..n] int;
+var first, lines: int;
+{
+  var r = f.reader();
+  var t, i: int;
+  while r.readln(t, i) {
+    if lines == 0 then first = t;
+    lines += 1;
+    if t == 0 then continue;
+    seen[t, i] += 1;
+  }
+  r.close();
+}
+
+writeln("lines: ", lines);
+writeln("first: ", first);
+writeln("each once: ", && reduce (seen == 1));
+f.close();
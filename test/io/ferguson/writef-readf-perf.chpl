@@ -0,0 +1,43 @@
+use IO, Time;
+
+// test writef/readf performance with the same format string each time
+
+config const n = 1000;
+config const timing = false;
+
+var f = openmem();
+
+var tw: Timer;
+{
+  var w = f.writer(locking=false);
+  tw.start();
+  for i in 1..n do
+    w.writef("%i %r\n", i, (i%1000):real/4);
+  tw.stop();
+  w.close();
+}
+
+var tr: Timer;
+var ok = true;
+{
+  var r = f.reader(locking=false);
+  var a: int, b: real;
+  tr.start();
+  for i in 1..n {
+    r.readf("%i %r\n", a, b);
+    if a != i || b != (i%1000):real/4 then ok = false;
+  }
+  tr.stop();
+  r.close();
+}
+
+f.close();
+
+if ok then writeln("Success");
+else writeln("Did not read back what was written");
+
+if timing {
+  writeln("n=", n);
+  writeln("writef time: ", tw.elapsed());
+  writeln("readf time: ", tr.elapsed());
+}
@@ -0,0 +1,27 @@
+// Print reals in the various styles. The expected output was
+// produced with printf-based formatting.
+use Random;
+
+config const n = 2000;
+
+const special = [0.0, -0.0, 1.0, -1.5, 0.1, 0.5, 2.5, 0.125, 1.0/3.0,
+                 100000.0, 123456.7, 999999.5, 999999.49999, 1000000.0,
+                 0.0001, 0.00001, 1e15, 1e16, 1e17, 9007199254740993.0,
+                 1.7976931348623157e308, 2.2250738585072014e-308,
+                 4.9406564584124654e-324, 6.02214076e23, 299792458.0];
+
+proc show(x: real) {
+  writeln(x, " ", -x);
+  writef("%r %er %dr %Er %.3r %.0r %.10r %.17r\n", x, x, x, x, x, x, x, x);
+  writef("%.0er %.4er %.16er %.2dr %.0dr %12.5r|%-12.5r|%+r\n",
+         x, x, x, x, x, x, x, x);
+  writef("%20.8er %ht %jt\n", x, x, x);
+}
+
+for x in special do show(x);
+
+var rs = new owned RandomStream(real, seed=271828);
+for i in 1..n {
+  const x = (rs.getNext() - 0.5) * 10.0 ** ((i % 80) - 40);
+  show(x);
+}
@@ -0,0 +1,51 @@
+use CommDiagnostics;
+
+extern type pthread_t;
+extern proc pthread_self(): pthread_t;
+extern proc pthread_equal(a: pthread_t, b: pthread_t): c_int;
+
+config const n = 10000;
+config const maxTries = 10;
+
+// Read a remote array in a task, then again in a subtask running on the
+// same pthread, and check that the subtask finds the pages its parent
+// cached.  The subtask's start acquire means it re-reads stale lines,
+// but none of its GETs should miss the cache entirely.
+var A:[1..n] int;
+for i in 1..n do A[i] = i;
+
+on Locales[1] {
+  var sum = 0;
+  for i in 1..n do sum += A[i];
+  assert(sum == n*(n+1)/2);
+
+  // fifo usually runs a cobegin's tasks on the thread that waits for
+  // them, but an idle thread can take one first.
+  const parent = pthread_self();
+  var checked = false;
+  for 1..maxTries {
+    var subSum = 0;
+    var samePthread = false;
+
+    resetCacheDiagnosticsHere();
+    startCommDiagnosticsHere();
+    cobegin with (ref subSum, ref samePthread) {
+      {
+        samePthread = pthread_equal(pthread_self(), parent) != 0;
+        for i in 1..n do subSum += A[i];
+      }
+      { }
+    }
+    stopCommDiagnosticsHere();
+    assert(subSum == sum);
+
+    if samePthread {
+      const cd = getCacheDiagnosticsHere();
+      assert(cd.get_misses == 0);
+      assert(cd.get_hits > cd.get_partial_hits);
+      checked = true;
+      break;
+    }
+  }
+  assert(checked);
+}
@@ -0,0 +1,27 @@
+use CommDiagnostics;
+
+config const n = 10000;
+
+// Read a remote array sequentially and check that the cache
+// diagnostics saw hits and used readahead.
+var A:[1..n] int;
+for i in 1..n do A[i] = i;
+
+resetCacheDiagnostics();
+startCommDiagnostics();
+on Locales[1] {
+  var sum = 0;
+  for i in 1..n do sum += A[i];
+  assert(sum == n*(n+1)/2);
+}
+stopCommDiagnostics();
+
+const cd = getCacheDiagnostics()[1];
+assert(cd.get_hits > 0);
+assert(cd.get_misses > 0);
+assert(cd.readahead_used <= cd.readahead_issued);
+assert(cd.get_hits > cd.get_misses + cd.get_partial_hits);
+
+resetCacheDiagnostics();
+const cd2 = getCacheDiagnostics()[1];
+assert(cd2.get_hits == 0 && cd2.get_misses == 0);
@@ -0,0 +1,34 @@
+config const n = 200;
+extern proc printf(fmt: c_string, vals...?numvals): int;
+config const verbose=false;
+
+// Read a row-major 2D array one column at a time, so that
+// consecutive GETs are a row apart (exercises the stride prefetcher).
+proc doit(memory:locale, running:locale) {
+  on memory {
+    var A:[1..n, 1..n] int;
+    for (i,j) in A.domain {
+      A[i,j] = i*n + j;
+    }
+    on running {
+      for j in 1..n {
+        for i in 1..n {
+          var got = A[i,j];
+          if verbose then
+            printf("on %d, reading A[%d,%d] got %d\n",
+                   here.id:c_int, i:c_int, j:c_int, got:c_int);
+          assert(got == i*n + j);
+        }
+      }
+      // and backwards, for a negative stride
+      for j in 1..n by -1 {
+        for i in 1..n by -1 {
+          var got = A[i,j];
+          assert(got == i*n + j);
+        }
+      }
+    }
+  }
+}
+
+doit(Locales[0], Locales[1]);
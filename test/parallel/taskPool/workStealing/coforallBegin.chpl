@@ -0,0 +1,29 @@
+//
+// With the work-stealing fifo task pool, the task that creates a
+// coforall has to run all of the coforall's tasks that are still in its
+// own deque, even when begins from those tasks are on top of them and
+// no other thread is free to steal anything.
+//
+config const n = 8;
+
+var started: atomic bool;
+var release$: sync bool;
+var total: atomic int;
+
+sync {
+  // keep the task pool thread busy until the coforall is done
+  begin {
+    started.write(true);
+    release$;
+  }
+  started.waitFor(true);
+
+  coforall i in 1..n {
+    begin total.add(i);
+    total.add(100 * i);
+  }
+
+  release$ = true;
+}
+
+writeln("total is ", total.read());
@@ -0,0 +1,46 @@
+//
+// Many small concurrent non-blocking on-statements, for the GASNet fork
+// aggregation in the .execenv.  Each fork carries the values its
+// creator had when it was made, so a fork that was copied too late or
+// delivered twice shows up as a wrong or extra entry.
+//
+config const tasksPerLocale = 4;
+config const forksPerTask = 2000;
+
+const D = {0..#numLocales, 0..#tasksPerLocale, 1..forksPerTask};
+var got: [D] int;
+var count: [0..#numLocales] atomic int;
+
+coforall loc in Locales do on loc {
+  const src = here.id;
+  coforall t in 0..#tasksPerLocale {
+    sync {
+      var k = 0;
+      while k < forksPerTask {
+        k += 1;
+        const dst = (src + 1 + k % (numLocales - 1)) % numLocales;
+        begin on Locales[dst] {
+          got[src, t, k] = k * numLocales + dst;
+          count[dst].add(1);
+        }
+        // a blocking on now and then; the forks before it must not be
+        // lost or reordered behind it
+        if k % 500 == 0 then
+          on Locales[dst] do count[dst].add(0);
+      }
+    }
+  }
+}
+
+var ok = true;
+for (src, t, k) in D {
+  const dst = (src + 1 + k % (numLocales - 1)) % numLocales;
+  if got[src, t, k] != k * numLocales + dst {
+    writeln("wrong value from locale ", src, " task ", t, " fork ", k);
+    ok = false;
+  }
+}
+
+writeln("forks received: ", + reduce [c in count] c.read());
+writeln("expected: ", numLocales * tasksPerLocale * forksPerTask);
+writeln(if ok then "all values correct" else "FAILED");
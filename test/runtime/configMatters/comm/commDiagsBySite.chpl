@@ -0,0 +1,19 @@
+//
+// With CHPL_RT_COMM_DIAGS_BY_SITE, the GETs and PUTs below should be
+// counted against the two lines they come from, and the on-statements
+// against the <unknown> site.
+//
+config const n = 100;
+
+var A: [1..n] int = 1..n;
+var B: [1..n] int;
+var sum: int;
+
+on Locales[1] {
+  var mySum = 0;
+  for i in 1..n do mySum += A[i];       // GETs
+  for i in 1..n by 2 do B[i] = i;       // PUTs
+  sum = mySum;
+}
+
+writeln(sum, " ", + reduce B);
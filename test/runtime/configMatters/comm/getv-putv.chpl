@@ -0,0 +1,61 @@
+//
+// Gather and scatter elements spread over all the locales with the
+// vectored chpl_comm_getv() and chpl_comm_putv() runtime calls.
+//
+use CPtr;
+
+extern type chpl_comm_nb_handle_t;
+extern proc chpl_comm_getv(n: size_t, addrs: c_ptr(c_void_ptr),
+                           nodes: c_ptr(int(32)), raddrs: c_ptr(c_void_ptr),
+                           sizes: c_ptr(size_t), typeIndex: int(32),
+                           commID: int(32), ln: c_int,
+                           fn: int(32)): chpl_comm_nb_handle_t;
+extern proc chpl_comm_putv(n: size_t, addrs: c_ptr(c_void_ptr),
+                           nodes: c_ptr(int(32)), raddrs: c_ptr(c_void_ptr),
+                           sizes: c_ptr(size_t), typeIndex: int(32),
+                           commID: int(32), ln: c_int,
+                           fn: int(32)): chpl_comm_nb_handle_t;
+extern proc chpl_comm_wait_nb_some(ref h: chpl_comm_nb_handle_t, n: size_t);
+
+config const n = 1000;
+
+// n is coprime with 13, so element i of the list refers to a distinct
+// remote element.
+proc whichLoc(i) return (i * 7) % numLocales;
+proc whichElt(i) return (i * 13) % n;
+
+var bases: [0..#numLocales] c_ptr(int);
+coforall loc in Locales do on loc {
+  const p = c_malloc(int, n);
+  for i in 0..#n do p[i] = here.id * 1000000 + i;
+  bases[here.id] = p;
+}
+
+var vals: [0..#n] int;
+var addrs: [0..#n] c_void_ptr, raddrs: [0..#n] c_void_ptr;
+var nodes: [0..#n] int(32);
+var sizes: [0..#n] size_t = numBytes(int): size_t;
+for i in 0..#n {
+  addrs[i] = c_ptrTo(vals[i]): c_void_ptr;
+  nodes[i] = whichLoc(i): int(32);
+  raddrs[i] = (bases[whichLoc(i)] + whichElt(i)): c_void_ptr;
+}
+
+var h = chpl_comm_getv(n: size_t, c_ptrTo(addrs), c_ptrTo(nodes),
+                       c_ptrTo(raddrs), c_ptrTo(sizes), -1, -1, 0, 0);
+chpl_comm_wait_nb_some(h, 1);
+writeln(&& reduce [i in 0..#n] vals[i] == whichLoc(i) * 1000000 + whichElt(i));
+
+vals = [i in 0..#n] -(i+1);
+h = chpl_comm_putv(n: size_t, c_ptrTo(addrs), c_ptrTo(nodes),
+                   c_ptrTo(raddrs), c_ptrTo(sizes), -1, -1, 0, 0);
+chpl_comm_wait_nb_some(h, 1);
+var ok = true;
+for i in 0..#n {
+  var v: int;
+  on Locales[whichLoc(i)] do v = bases[here.id][whichElt(i)];
+  if v != -(i+1) then ok = false;
+}
+writeln(ok);
+
+coforall loc in Locales do on loc do c_free(bases[here.id]);
@@ -0,0 +1,49 @@
+/* Test that a module's function still shadows one from a module it
+   uses while calls keep instantiating new types, which adds their
+   initializers to blocks that earlier calls have already searched. */
+module Far {
+  record Box {
+    var x;
+  }
+
+  proc describe(b) {
+    return "Far.describe(" + b.x:string + ")";
+  }
+
+  proc show(b) {
+    writeln(describe(b));
+  }
+}
+
+module Near {
+  use Far;
+
+  // shadows Far.describe for code that uses Near
+  proc describe(b) {
+    return "Near.describe(" + b.x:string + ")";
+  }
+}
+
+module Main {
+  proc main() {
+    {
+      use Far;
+
+      writeln(describe(new Box(1)));
+      show(new Box(2.0));
+    }
+
+    {
+      use Near;
+
+      writeln(describe(new Box(3)));
+      writeln(describe(new Box(true)));
+
+      // Far.describe is found from where show is defined
+      show(new Box("four"));
+
+      writeln(describe(new Box(5.0)));
+      show(new Box(6));
+    }
+  }
+}